@@ -0,0 +1,421 @@
+#include "CompiledDictionary.h"
+#include "Words.h"
+#include "WordMetrics.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Words {
+
+    namespace {
+        const char IMAGE_MAGIC[8] = { 'W', 'P', 'D', 'I', 'C', 'T', '\0', '\0' };
+
+        struct ImageHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t wordCount;
+            std::uint64_t sourceSize;          // Byte size of the CSV this image was compiled from
+            std::uint64_t fileSize;            // Total image size, guards against truncated files
+            std::uint64_t recordsOffset;
+            std::uint64_t textOffsetsOffset;
+            std::uint64_t posOffsetsOffset;
+            std::uint64_t definitionOffsetsOffset;
+            std::uint64_t sentenceOffsetsOffset;
+            std::uint64_t stringPoolOffset;
+            std::uint64_t stringPoolSize;
+        };
+        static_assert(sizeof(ImageHeader) == 88, "ImageHeader layout is part of the file format");
+
+        struct ImageRecord {
+            std::int32_t rarity;
+            float avgSubLen;
+            std::int32_t countGE3;
+            std::int32_t countGE4;
+            std::int32_t countGE5;
+            std::int32_t easyValidCount;
+            std::int32_t mediumValidCount;
+            std::int32_t hardValidCount;
+        };
+        static_assert(sizeof(ImageRecord) == 32, "ImageRecord layout is part of the file format");
+
+        std::uint64_t alignTo8(std::uint64_t v) { return (v + 7) & ~std::uint64_t(7); }
+
+        // Appends one field of every word to the pool and fills its offset table
+        template <typename Getter>
+        bool appendField(const std::vector<WordInfo>& words, std::string& pool, std::vector<std::uint32_t>& offsets, Getter get) {
+            offsets.clear();
+            offsets.reserve(words.size() + 1);
+            for (std::size_t i = 0; i < words.size(); ++i) {
+                if (pool.size() > std::numeric_limits<std::uint32_t>::max()) return false;
+                offsets.push_back(static_cast<std::uint32_t>(pool.size()));
+                pool += get(i);
+            }
+            if (pool.size() > std::numeric_limits<std::uint32_t>::max()) return false;
+            offsets.push_back(static_cast<std::uint32_t>(pool.size()));
+            return true;
+        }
+
+        void writePadding(std::ofstream& out, std::uint64_t from, std::uint64_t to) {
+            static const char zeros[8] = {};
+            if (to > from) out.write(zeros, static_cast<std::streamsize>(to - from));
+        }
+
+        bool offsetsValid(const std::uint32_t* offsets, std::size_t count, std::uint64_t poolSize) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (offsets[i] > offsets[i + 1]) return false;
+            }
+            return offsets[count] <= poolSize;
+        }
+
+        // [offset, offset + size) ends at or before 'limit'; compared without the sum,
+        // so offsets from a corrupt header cannot wrap around
+        bool sectionFits(std::uint64_t offset, std::uint64_t size, std::uint64_t limit) {
+            return offset <= limit && size <= limit - offset;
+        }
+    }
+
+
+    std::string compiledPathFor(const std::string& csvPath) {
+        std::filesystem::path p(csvPath);
+        p.replace_extension(".wpd");
+        return p.string();
+    }
+
+
+    bool writeCompiledWordList(const std::vector<WordInfo>& words, const WordDetailsStore& details,
+        const std::string& imagePath, const std::string& sourceCsvPath) {
+        if (words.size() > std::numeric_limits<std::uint32_t>::max()) {
+            std::cerr << "Error: Too many words to compile (" << words.size() << ")." << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        std::uint64_t sourceSize = std::filesystem::file_size(sourceCsvPath, ec);
+        if (ec) {
+            std::cerr << "Error: Could not stat source word list " << sourceCsvPath << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        // Details are fetched once per word (each fetch may hit the CSV) and kept only for the compile
+        std::vector<WordDetails> allDetails;
+        allDetails.reserve(words.size());
+        for (const auto& info : words) {
+            allDetails.push_back(details.get(info.detailsId));
+        }
+
+        std::string pool;
+        std::vector<std::uint32_t> textOffsets, posOffsets, definitionOffsets, sentenceOffsets;
+        bool poolOk = appendField(words, pool, textOffsets, [&](std::size_t i) -> const std::string& { return words[i].text; })
+            && appendField(words, pool, posOffsets, [&](std::size_t i) -> const std::string& { return allDetails[i].pos; })
+            && appendField(words, pool, definitionOffsets, [&](std::size_t i) -> const std::string& { return allDetails[i].definition; })
+            && appendField(words, pool, sentenceOffsets, [&](std::size_t i) -> const std::string& { return allDetails[i].sentence; });
+        if (!poolOk) {
+            std::cerr << "Error: String pool exceeds 4 GB, cannot compile " << sourceCsvPath << std::endl;
+            return false;
+        }
+
+        const std::uint64_t count = words.size();
+        const std::uint64_t tableBytes = (count + 1) * sizeof(std::uint32_t);
+
+        ImageHeader header{};
+        std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+        header.version = COMPILED_DICTIONARY_VERSION;
+        header.wordCount = static_cast<std::uint32_t>(count);
+        header.sourceSize = sourceSize;
+        header.recordsOffset = alignTo8(sizeof(ImageHeader));
+        header.textOffsetsOffset = alignTo8(header.recordsOffset + count * sizeof(ImageRecord));
+        header.posOffsetsOffset = alignTo8(header.textOffsetsOffset + tableBytes);
+        header.definitionOffsetsOffset = alignTo8(header.posOffsetsOffset + tableBytes);
+        header.sentenceOffsetsOffset = alignTo8(header.definitionOffsetsOffset + tableBytes);
+        header.stringPoolOffset = alignTo8(header.sentenceOffsetsOffset + tableBytes);
+        header.stringPoolSize = pool.size();
+        header.fileSize = header.stringPoolOffset + header.stringPoolSize;
+
+        // Write to a temporary file first so a failed compile never leaves a half-written image behind
+        const std::string tempPath = imagePath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                std::cerr << "Error: Could not create compiled word list " << tempPath << std::endl;
+                return false;
+            }
+
+            std::uint64_t written = 0;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            written += sizeof(header);
+            writePadding(out, written, header.recordsOffset); written = header.recordsOffset;
+
+            for (const auto& info : words) {
+                ImageRecord rec{};
+                rec.rarity = info.rarity;
+                rec.avgSubLen = info.avgSubLen;
+                rec.countGE3 = info.countGE3;
+                rec.countGE4 = info.countGE4;
+                rec.countGE5 = info.countGE5;
+                rec.easyValidCount = info.easyValidCount;
+                rec.mediumValidCount = info.mediumValidCount;
+                rec.hardValidCount = info.hardValidCount;
+                out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+            }
+            written += count * sizeof(ImageRecord);
+
+            const std::pair<std::uint64_t, const std::vector<std::uint32_t>*> tables[] = {
+                { header.textOffsetsOffset, &textOffsets },
+                { header.posOffsetsOffset, &posOffsets },
+                { header.definitionOffsetsOffset, &definitionOffsets },
+                { header.sentenceOffsetsOffset, &sentenceOffsets },
+            };
+            for (const auto& table : tables) {
+                writePadding(out, written, table.first); written = table.first;
+                out.write(reinterpret_cast<const char*>(table.second->data()), static_cast<std::streamsize>(tableBytes));
+                written += tableBytes;
+            }
+
+            writePadding(out, written, header.stringPoolOffset);
+            out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+
+            if (!out.good()) {
+                std::cerr << "Error: Failed while writing compiled word list " << tempPath << std::endl;
+                out.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, imagePath, ec);
+        if (ec) {
+            // rename() does not replace an existing file on every platform
+            std::filesystem::remove(imagePath, ec);
+            std::filesystem::rename(tempPath, imagePath, ec);
+        }
+        if (ec) {
+            std::cerr << "Error: Could not move compiled word list into place at " << imagePath << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        std::cout << "Compiled " << count << " words (" << header.fileSize << " bytes) to " << imagePath << std::endl;
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------
+    //  CompiledDictionary
+    //--------------------------------------------------------------------
+    struct CompiledDictionary::Mapping {
+        const unsigned char* data = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+
+        bool map(const std::string& path) {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER fileSize{};
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) return false;
+            data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            return data != nullptr;
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st {};
+            if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+            void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // The mapping stays valid after the descriptor is closed
+            if (p == MAP_FAILED) return false;
+            data = static_cast<const unsigned char*>(p);
+            size = static_cast<std::size_t>(st.st_size);
+            return true;
+#endif
+        }
+
+        ~Mapping() {
+#ifdef _WIN32
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+            if (data) munmap(const_cast<unsigned char*>(data), size);
+#endif
+        }
+    };
+
+    CompiledDictionary::CompiledDictionary() = default;
+    CompiledDictionary::~CompiledDictionary() = default;
+    CompiledDictionary::CompiledDictionary(CompiledDictionary&&) noexcept = default;
+    CompiledDictionary& CompiledDictionary::operator=(CompiledDictionary&&) noexcept = default;
+
+
+    bool CompiledDictionary::open(const std::string& imagePath, const std::string& sourceCsvPath) {
+        close();
+
+        std::error_code ec;
+        if (!std::filesystem::exists(imagePath, ec)) {
+            return false; // Not compiled yet, caller falls back to the CSV silently
+        }
+
+        // Staleness: the image must be at least as new as the CSV and record its exact size.
+        // A missing CSV is fine (the image can ship on its own).
+        std::uint64_t csvSize = 0;
+        bool haveCsv = std::filesystem::exists(sourceCsvPath, ec);
+        if (haveCsv) {
+            csvSize = std::filesystem::file_size(sourceCsvPath, ec);
+            auto csvTime = std::filesystem::last_write_time(sourceCsvPath, ec);
+            auto imageTime = std::filesystem::last_write_time(imagePath, ec);
+            if (!ec && csvTime > imageTime) {
+                std::cerr << "Warning: Compiled word list " << imagePath << " is older than " << sourceCsvPath << "; ignoring it." << std::endl;
+                return false;
+            }
+        }
+
+        auto mapping = std::make_unique<Mapping>();
+        if (!mapping->map(imagePath)) {
+            std::cerr << "Warning: Could not map compiled word list " << imagePath << std::endl;
+            return false;
+        }
+        if (mapping->size < sizeof(ImageHeader)) {
+            std::cerr << "Warning: Compiled word list " << imagePath << " is truncated; ignoring it." << std::endl;
+            return false;
+        }
+
+        ImageHeader header;
+        std::memcpy(&header, mapping->data, sizeof(header));
+        if (std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 || header.version != COMPILED_DICTIONARY_VERSION) {
+            std::cerr << "Warning: Compiled word list " << imagePath << " has an unknown format or version " << header.version
+                << " (expected " << COMPILED_DICTIONARY_VERSION << "); ignoring it." << std::endl;
+            return false;
+        }
+        if (haveCsv && header.sourceSize != csvSize) {
+            std::cerr << "Warning: Compiled word list " << imagePath << " was built from a different " << sourceCsvPath << "; ignoring it." << std::endl;
+            return false;
+        }
+
+        // A count past what the file could hold is rejected first, so the section sizes below cannot overflow
+        const std::uint64_t count = header.wordCount;
+        const std::uint64_t fileSize = mapping->size;
+        const std::uint64_t sections[] = { header.recordsOffset, header.textOffsetsOffset, header.posOffsetsOffset,
+            header.definitionOffsetsOffset, header.sentenceOffsetsOffset, header.stringPoolOffset };
+        bool layoutOk = header.fileSize == fileSize && count < fileSize / sizeof(ImageRecord);
+        const std::uint64_t tableBytes = layoutOk ? (count + 1) * sizeof(std::uint32_t) : 0;
+        layoutOk = layoutOk
+            && sectionFits(header.recordsOffset, count * sizeof(ImageRecord), header.textOffsetsOffset)
+            && sectionFits(header.textOffsetsOffset, tableBytes, header.posOffsetsOffset)
+            && sectionFits(header.posOffsetsOffset, tableBytes, header.definitionOffsetsOffset)
+            && sectionFits(header.definitionOffsetsOffset, tableBytes, header.sentenceOffsetsOffset)
+            && sectionFits(header.sentenceOffsetsOffset, tableBytes, header.stringPoolOffset)
+            && sectionFits(header.stringPoolOffset, header.stringPoolSize, fileSize);
+        for (std::uint64_t s : sections) layoutOk = layoutOk && (s % 8 == 0);
+        if (!layoutOk) {
+            std::cerr << "Warning: Compiled word list " << imagePath << " is corrupt; ignoring it." << std::endl;
+            return false;
+        }
+
+        const unsigned char* base = mapping->data;
+        const auto* textOffsets = reinterpret_cast<const std::uint32_t*>(base + header.textOffsetsOffset);
+        const auto* posOffsets = reinterpret_cast<const std::uint32_t*>(base + header.posOffsetsOffset);
+        const auto* definitionOffsets = reinterpret_cast<const std::uint32_t*>(base + header.definitionOffsetsOffset);
+        const auto* sentenceOffsets = reinterpret_cast<const std::uint32_t*>(base + header.sentenceOffsetsOffset);
+        if (!offsetsValid(textOffsets, count, header.stringPoolSize) || !offsetsValid(posOffsets, count, header.stringPoolSize)
+            || !offsetsValid(definitionOffsets, count, header.stringPoolSize) || !offsetsValid(sentenceOffsets, count, header.stringPoolSize)) {
+            std::cerr << "Warning: Compiled word list " << imagePath << " has out-of-range string offsets; ignoring it." << std::endl;
+            return false;
+        }
+
+        m_wordCount = static_cast<std::size_t>(count);
+        m_records = base + header.recordsOffset;
+        m_textOffsets = textOffsets;
+        m_posOffsets = posOffsets;
+        m_definitionOffsets = definitionOffsets;
+        m_sentenceOffsets = sentenceOffsets;
+        m_stringPool = reinterpret_cast<const char*>(base + header.stringPoolOffset);
+        m_mapping = std::move(mapping);
+        return true;
+    }
+
+
+    void CompiledDictionary::close() {
+        m_mapping.reset();
+        m_wordCount = 0;
+        m_records = nullptr;
+        m_textOffsets = m_posOffsets = m_definitionOffsets = m_sentenceOffsets = nullptr;
+        m_stringPool = nullptr;
+    }
+
+
+    WordInfo CompiledDictionary::wordInfo(std::size_t i) const {
+        ImageRecord rec;
+        std::memcpy(&rec, m_records + i * sizeof(ImageRecord), sizeof(rec));
+        return WordInfo(std::string(text(i)), rec.rarity, static_cast<std::uint32_t>(i),
+            rec.avgSubLen, rec.countGE3, rec.countGE4, rec.countGE5,
+            rec.easyValidCount, rec.mediumValidCount, rec.hardValidCount);
+    }
+
+
+    std::vector<WordInfo> CompiledDictionary::toWordList() const {
+        std::vector<WordInfo> words;
+        words.reserve(m_wordCount);
+        for (std::size_t i = 0; i < m_wordCount; ++i) {
+            words.push_back(wordInfo(i));
+        }
+        return words;
+    }
+
+
+    std::vector<WordInfo> loadWordList(const std::string& csvPath, WordDetailsStore& details) {
+        const std::string imagePath = compiledPathFor(csvPath);
+        const std::string metricsPath = metricsPathFor(csvPath);
+        std::vector<WordInfo> words;
+        std::error_code ec;
+        bool metricsUsable = std::filesystem::exists(metricsPath, ec);
+
+        auto image = std::make_unique<CompiledDictionary>();
+        if (image->open(imagePath, csvPath)) {
+            words = image->toWordList();
+            std::cout << "Successfully loaded " << words.size() << " words from compiled image: " << imagePath << std::endl;
+            details.attachImage(std::move(image)); // Keeps the mapping alive for definition lookups
+
+            // The image carries the metrics it was compiled with; only a newer sidecar overrides them
+            if (metricsUsable) {
+                auto imageTime = std::filesystem::last_write_time(imagePath, ec);
+                auto metricsTime = std::filesystem::last_write_time(metricsPath, ec);
+                metricsUsable = !ec && metricsTime > imageTime;
+            }
+        }
+        else {
+            words = loadProcessedWordList(csvPath, &details);
+            if (!metricsUsable && !words.empty()) {
+                std::cerr << "Warning: No word metrics for " << csvPath << " (run WordMetrics); base words will be picked without them." << std::endl;
+            }
+        }
+
+        if (metricsUsable) {
+            std::size_t updated = applyWordMetrics(words, metricsPath);
+            if (updated > 0) std::cout << "Applied pre-calculated metrics to " << updated << " words from: " << metricsPath << std::endl;
+        }
+        return words;
+    }
+
+} // namespace Words
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef COMPILEDDICTIONARY_H
+#define COMPILEDDICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Compiled (binary) word list
+//--------------------------------------------------------------------
+// words_processed.csv is compiled offline (tools/DictionaryCompiler) into a
+// versioned image that the game memory-maps at startup instead of parsing.
+//
+// Image layout (little-endian, every section 8-byte aligned):
+//   ImageHeader
+//   ImageRecord[wordCount]                 rarity + pre-calculated metrics
+//   uint32 textOffsets[wordCount + 1]      offsets into the string pool
+//   uint32 posOffsets[wordCount + 1]
+//   uint32 definitionOffsets[wordCount + 1]
+//   uint32 sentenceOffsets[wordCount + 1]
+//   char   stringPool[]                    all texts, then all pos, ... (no terminators)
+// A field's length is offsets[i + 1] - offsets[i].
+namespace Words {
+
+    class WordDetailsStore;
+
+    constexpr std::uint32_t COMPILED_DICTIONARY_VERSION = 1;
+
+    // "words_processed.csv" -> "words_processed.wpd"
+    std::string compiledPathFor(const std::string& csvPath);
+
+    // Writes 'words' (details resolved through 'details') as a compiled image.
+    // 'sourceCsvPath' is recorded so the loader can tell when the CSV has changed.
+    bool writeCompiledWordList(const std::vector<WordInfo>& words, const WordDetailsStore& details,
+        const std::string& imagePath, const std::string& sourceCsvPath);
+
+    // Read-only view of a memory-mapped compiled image.
+    class CompiledDictionary {
+    public:
+        CompiledDictionary();
+        ~CompiledDictionary();
+        CompiledDictionary(const CompiledDictionary&) = delete;
+        CompiledDictionary& operator=(const CompiledDictionary&) = delete;
+        CompiledDictionary(CompiledDictionary&&) noexcept;
+        CompiledDictionary& operator=(CompiledDictionary&&) noexcept;
+
+        // Maps the image. Fails (and prints why) when the file is missing,
+        // truncated, from another format version, or older than its source CSV.
+        bool open(const std::string& imagePath, const std::string& sourceCsvPath);
+        void close();
+        bool isOpen() const { return m_mapping != nullptr; }
+
+        std::size_t size() const { return m_wordCount; }
+        std::string_view text(std::size_t i) const { return field(m_textOffsets, i); }
+        std::string_view pos(std::size_t i) const { return field(m_posOffsets, i); }
+        std::string_view definition(std::size_t i) const { return field(m_definitionOffsets, i); }
+        std::string_view sentence(std::size_t i) const { return field(m_sentenceOffsets, i); }
+
+        // Materializes entry 'i' / every entry as WordInfo (detailsId == i)
+        WordInfo wordInfo(std::size_t i) const;
+        std::vector<WordInfo> toWordList() const;
+
+    private:
+        struct Mapping; // Platform file mapping (mmap / MapViewOfFile)
+
+        std::string_view field(const std::uint32_t* offsets, std::size_t i) const {
+            return std::string_view(m_stringPool + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+
+        std::unique_ptr<Mapping> m_mapping;
+        std::size_t m_wordCount = 0;
+        const unsigned char* m_records = nullptr;
+        const std::uint32_t* m_textOffsets = nullptr;
+        const std::uint32_t* m_posOffsets = nullptr;
+        const std::uint32_t* m_definitionOffsets = nullptr;
+        const std::uint32_t* m_sentenceOffsets = nullptr;
+        const char* m_stringPool = nullptr;
+    };
+
+    // Loads the word list from the compiled image next to 'csvPath' when it is
+    // present and up to date, otherwise falls back to parsing the CSV.
+    // 'details' is attached to whichever source was used. Root-word metrics come
+    // from the image, or from the metrics sidecar (see WordMetrics.h) when that is newer.
+    std::vector<WordInfo> loadWordList(const std::string& csvPath, WordDetailsStore& details);
+
+} // namespace Words
+
+#endif // COMPILEDDICTIONARY_H
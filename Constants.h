@@ -4,6 +4,8 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include "PuzzleRules.h"
+
 // Gameplay constants
 constexpr unsigned int REF_W = 1000;
 constexpr unsigned int REF_H = 800;
@@ -34,6 +36,10 @@ constexpr float SCRAMBLE_BTN_OFFSET_X = 80.f;// Keep as is
 constexpr float SCRAMBLE_BTN_OFFSET_Y = 125.f;// Keep as is
 constexpr float CONTINUE_BTN_OFFSET_Y = 80.f;
 constexpr float WORD_LENGTH = 5.f; // Or 6.f or 7.f as needed
+constexpr double CROSSWORD_TIME_BUDGET_MS = 100.0; // Caps crossword layout search per m_rebuild (usually done in a few ms)
+constexpr int CROSSWORD_IDLE_TRIALS = 200;          // Background trials per crossword puzzle towards the layout cache
+constexpr double CROSSWORD_IDLE_BUDGET_MS = 500.0;
+constexpr const char* CROSSWORD_CACHE_PATH = "crossword_layouts.cache";
 constexpr float GRID_SIDE_MARGIN = 5.f;
 constexpr float MIN_WINDOW_HEIGHT = 800.f;
 constexpr float MIN_WINDOW_WIDTH = 1000.f;
@@ -42,17 +48,7 @@ constexpr float SCORE_BAR_HEIGHT = 30.f;
 constexpr float SCORE_BAR_TOP_MARGIN = 15.f;
 constexpr float SCRAMBLE_BTN_HEIGHT = 40.f;
 constexpr float HINT_BTN_HEIGHT = SCRAMBLE_BTN_HEIGHT;
-const int MIN_WORD_LENGTH = 3;
-const int HARD_MIN_WORD_LENGTH = 4;
-
-const int EASY_MAX_SOLUTIONS = 7;
-const int MEDIUM_MAX_SOLUTIONS = 12;
-const int HARD_MAX_SOLUTIONS = 15;
-const int MIN_DESIRED_GRID_WORDS = 5;
-
-const int CROSSWORD_EASY_MAX_SOLUTIONS = 10;
-const int CROSSWORD_MEDIUM_MAX_SOLUTIONS = 15;
-const int CROSSWORD_HARD_MAX_SOLUTIONS = 20;
+// Word-length / solution-count rules live in PuzzleRules.h (shared with tools/)
 
 const int HINT_COST_REVEAL_FIRST = 2; 
 const int HINT_COST_REVEAL_RANDOM = 3; 
@@ -189,6 +185,9 @@ const unsigned int SCORE_ZONE_BONUS_FONT_SIZE = 10;
 const sf::Color GLOWING_TUBE_TEXT_COLOR = sf::Color(255, 190, 70); // Orange glowing (matches grid letter)
 // const sf::Color GLOWING_TUBE_TEXT_COLOR = sf::Color(60, 220, 200); // Brighter variant
 
+// Guess letters and drag path once no puzzle word starts with the letters dragged so far
+const sf::Color GUESS_DEAD_END_COLOR = sf::Color(140, 140, 140);
+
 
 
 #endif // CONSTANTS_H
\ No newline at end of file
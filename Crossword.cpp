@@ -1,8 +1,12 @@
 #include "Crossword.h"
+#include "CrosswordCache.h"
+#include "Seed.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
 #include <cctype>
-#include <climits>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <random>
 #include <string>
@@ -10,22 +14,116 @@
 namespace {
 
 struct PlacedWord {
-    std::string text;
+    int wordIndex; // Into the trial's words
+    int length;
     int startRow;
     int startCol;
     Direction dir;
 };
 
-char cellAt(const std::vector<PlacedWord>& placed,
-            const std::map<std::pair<int,int>, char>& occupiedCells,
-            int r, int c)
-{
-    auto it = occupiedCells.find({r, c});
-    return it != occupiedCells.end() ? it->second : '\0';
-}
+// Placed letters in a flat row-major array addressed relative to a movable origin.
+// Reads outside the allocated area are empty; writes there grow (and re-centre) it.
+class LetterGrid {
+public:
+    // 'expectedSpan': expected extent of the layout in either direction
+    explicit LetterGrid(int expectedSpan) {
+        m_reset(-expectedSpan, -expectedSpan, 2 * expectedSpan + 1, 2 * expectedSpan + 1);
+    }
+
+    char at(int r, int c) const {
+        const unsigned rr = static_cast<unsigned>(r - m_originRow);
+        const unsigned cc = static_cast<unsigned>(c - m_originCol);
+        if (rr >= static_cast<unsigned>(m_rows) || cc >= static_cast<unsigned>(m_cols)) return '\0';
+        return m_cells[rr * static_cast<unsigned>(m_cols) + cc];
+    }
+
+    void set(int r, int c, char ch) {
+        if (r < m_originRow || r >= m_originRow + m_rows || c < m_originCol || c >= m_originCol + m_cols) {
+            m_grow(r, c);
+        }
+        m_cells[static_cast<std::size_t>(r - m_originRow) * m_cols + (c - m_originCol)] = ch;
+    }
+
+private:
+    void m_reset(int originRow, int originCol, int rows, int cols) {
+        m_originRow = originRow;
+        m_originCol = originCol;
+        m_rows = rows;
+        m_cols = cols;
+        m_cells.assign(static_cast<std::size_t>(rows) * cols, '\0');
+    }
+
+    // Doubles the area (at least) so that (r, c) fits, keeping existing letters
+    void m_grow(int r, int c) {
+        const int minRow = std::min(r, m_originRow), maxRow = std::max(r, m_originRow + m_rows - 1);
+        const int minCol = std::min(c, m_originCol), maxCol = std::max(c, m_originCol + m_cols - 1);
+        const int padRows = std::max(m_rows, maxRow - minRow + 1) / 2;
+        const int padCols = std::max(m_cols, maxCol - minCol + 1) / 2;
+
+        std::vector<char> old = std::move(m_cells);
+        const int oldOriginRow = m_originRow, oldOriginCol = m_originCol, oldRows = m_rows, oldCols = m_cols;
+        m_reset(minRow - padRows, minCol - padCols, maxRow - minRow + 1 + 2 * padRows, maxCol - minCol + 1 + 2 * padCols);
+        for (int row = 0; row < oldRows; ++row) {
+            std::copy_n(old.begin() + static_cast<std::ptrdiff_t>(row) * oldCols, oldCols,
+                m_cells.begin() + static_cast<std::ptrdiff_t>(row + oldOriginRow - m_originRow) * m_cols + (oldOriginCol - m_originCol));
+        }
+    }
+
+    std::vector<char> m_cells;
+    int m_originRow = 0;
+    int m_originCol = 0;
+    int m_rows = 0;
+    int m_cols = 0;
+};
+
+// Which word put a letter in a cell: (placed index, letter index)
+using CellOwner = std::pair<int, int>;
+
+// A letter already on the board, as one cell of one placed word
+struct Anchor {
+    int row;
+    int col;
+    Direction dir;   // Direction of the placed word through this cell
+    int placedIndex; // Into the trial's placed words
+    int letterIndex; // Position of the cell in that word
+    char letter;
+};
+
+// Board cells grouped by letter, so intersection candidates for a new word are
+// listed directly instead of comparing it against every placed word
+class LetterIndex {
+public:
+    static constexpr int OTHER_BUCKET = 26; // Anything outside a-z; compared exactly
+
+    static int bucketFor(char ch) {
+        return (ch >= 'a' && ch <= 'z') ? ch - 'a' : OTHER_BUCKET;
+    }
+
+    void addWord(const std::string& lowerText, int startRow, int startCol, Direction dir, int placedIndex) {
+        for (int i = 0; i < static_cast<int>(lowerText.size()); ++i) {
+            const int r = (dir == Direction::Horizontal) ? startRow : startRow + i;
+            const int c = (dir == Direction::Horizontal) ? startCol + i : startCol;
+            m_buckets[bucketFor(lowerText[i])].push_back({ r, c, dir, placedIndex, i, lowerText[i] });
+        }
+    }
+
+    const std::vector<Anchor>& anchors(int bucket) const { return m_buckets[bucket]; }
+
+    // First placed word through an occupied cell (a few anchors per letter, only
+    // asked at intersections, so cheaper than an owner grid that beam states copy)
+    CellOwner ownerAt(char ch, int r, int c) const {
+        for (const Anchor& anchor : m_buckets[bucketFor(ch)]) {
+            if (anchor.row == r && anchor.col == c) return { anchor.placedIndex, anchor.letterIndex };
+        }
+        return { -1, -1 };
+    }
+
+private:
+    std::vector<Anchor> m_buckets[OTHER_BUCKET + 1];
+};
 
 bool canPlace(const std::string& word, int startRow, int startCol, Direction dir,
-              const std::map<std::pair<int,int>, char>& occupiedCells,
+              const LetterGrid& occupiedCells,
               int& intersectionCount)
 {
     intersectionCount = 0;
@@ -34,7 +132,7 @@ bool canPlace(const std::string& word, int startRow, int startCol, Direction dir
     for (int i = 0; i < len; ++i) {
         int r = (dir == Direction::Horizontal) ? startRow : startRow + i;
         int c = (dir == Direction::Horizontal) ? startCol + i : startCol;
-        char existing = cellAt({}, occupiedCells, r, c);
+        char existing = occupiedCells.at(r, c);
         char wch = static_cast<char>(std::tolower(static_cast<unsigned char>(word[i])));
 
         if (existing != '\0') {
@@ -44,12 +142,12 @@ bool canPlace(const std::string& word, int startRow, int startCol, Direction dir
             // Adjacent cells perpendicular to the word must be empty
             // (unless they are part of an intersecting word, handled by the intersection itself)
             if (dir == Direction::Horizontal) {
-                char above = cellAt({}, occupiedCells, r - 1, c);
-                char below = cellAt({}, occupiedCells, r + 1, c);
+                char above = occupiedCells.at(r - 1, c);
+                char below = occupiedCells.at(r + 1, c);
                 if (above != '\0' || below != '\0') return false;
             } else {
-                char left  = cellAt({}, occupiedCells, r, c - 1);
-                char right = cellAt({}, occupiedCells, r, c + 1);
+                char left  = occupiedCells.at(r, c - 1);
+                char right = occupiedCells.at(r, c + 1);
                 if (left != '\0' || right != '\0') return false;
             }
         }
@@ -58,241 +156,661 @@ bool canPlace(const std::string& word, int startRow, int startCol, Direction dir
     // Check cell before the word start
     int beforeR = (dir == Direction::Horizontal) ? startRow : startRow - 1;
     int beforeC = (dir == Direction::Horizontal) ? startCol - 1 : startCol;
-    if (cellAt({}, occupiedCells, beforeR, beforeC) != '\0') return false;
+    if (occupiedCells.at(beforeR, beforeC) != '\0') return false;
 
     // Check cell after the word end
     int afterR = (dir == Direction::Horizontal) ? startRow : startRow + len;
     int afterC = (dir == Direction::Horizontal) ? startCol + len : startCol;
-    if (cellAt({}, occupiedCells, afterR, afterC) != '\0') return false;
+    if (occupiedCells.at(afterR, afterC) != '\0') return false;
 
     return intersectionCount > 0;
 }
 
-void shuffleWithinLengthGroups(std::vector<WordInfo>& words, std::mt19937& rng) {
+// 'order' holds positions in 'words', sorted by length
+void shuffleWithinLengthGroups(std::vector<std::size_t>& order, const CrosswordWords& words, std::mt19937& rng) {
     size_t i = 0;
-    while (i < words.size()) {
+    while (i < order.size()) {
         size_t j = i;
-        while (j < words.size() && words[j].text.size() == words[i].text.size()) ++j;
+        while (j < order.size() && words.text(order[j]).size() == words.text(order[i]).size()) ++j;
         if (j - i > 1) {
-            std::shuffle(words.begin() + static_cast<std::ptrdiff_t>(i),
-                         words.begin() + static_cast<std::ptrdiff_t>(j), rng);
+            std::shuffle(order.begin() + static_cast<std::ptrdiff_t>(i),
+                         order.begin() + static_cast<std::ptrdiff_t>(j), rng);
         }
         i = j;
     }
 }
 
-} // anonymous namespace
-
-static CrosswordResult generateCrosswordTrial(const std::vector<WordInfo>& words, std::mt19937& rng) {
-    CrosswordResult result;
-    if (words.empty()) return result;
+// The words of one trial in placement order: longest first, shuffled within each length
+struct TrialWords {
+    std::vector<std::size_t> order; // Positions in the input words
+    std::vector<std::string> lower; // Lowercase once per trial, parallel to 'order'
+    int totalLetters = 0;
+};
 
-    std::vector<WordInfo> sortedWords = words;
-    std::sort(sortedWords.begin(), sortedWords.end(),
-        [](const WordInfo& a, const WordInfo& b) {
-            return a.text.size() > b.text.size();
+TrialWords prepareTrialWords(const CrosswordWords& words, std::mt19937& rng) {
+    TrialWords trial;
+    trial.order.resize(words.size());
+    for (std::size_t i = 0; i < words.size(); ++i) trial.order[i] = i;
+    std::sort(trial.order.begin(), trial.order.end(),
+        [&words](std::size_t a, std::size_t b) {
+            return words.text(a).size() > words.text(b).size();
         });
-    shuffleWithinLengthGroups(sortedWords, rng);
+    shuffleWithinLengthGroups(trial.order, words, rng);
 
-    std::uniform_real_distribution<double> jitterDist(0.0, 4.0);
+    trial.lower.reserve(trial.order.size());
+    for (std::size_t i : trial.order) {
+        std::string lower = words.text(i);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        trial.totalLetters += static_cast<int>(lower.size());
+        trial.lower.push_back(std::move(lower));
+    }
+    return trial;
+}
 
+// A cell crossed by two placed words
+struct SharedCell {
+    int row;
+    int col;
+    CellOwner first;  // Earlier placed word
+    CellOwner second;
+};
+
+// A partial layout: placed words, their letters, intersections and the current bounds,
+// all kept up to date by place()
+struct Board {
     std::vector<PlacedWord> placed;
-    std::map<std::pair<int,int>, char> occupiedCells;
+    std::vector<SharedCell> sharedCells;
+    LetterGrid occupiedCells;
+    LetterIndex letterIndex;
+    int minRow = 0, maxRow = 0;
+    int minCol = 0, maxCol = 0;
+
+    // Starts with the first (longest) word across at the origin
+    explicit Board(const TrialWords& trial)
+        // Every word crosses an earlier one, so the layout spans at most all letters minus
+        // the overlaps; in practice it stays within about half of that around the origin.
+        : occupiedCells(std::max(trial.totalLetters / 2, static_cast<int>(trial.lower[0].size())) + 1) {
+        place(0, trial.lower[0], 0, 0, Direction::Horizontal);
+        minCol = 0;
+        maxCol = static_cast<int>(trial.lower[0].size()) - 1;
+    }
 
-    {
-        const std::string& firstWord = sortedWords[0].text;
+    void place(int wordIndex, const std::string& lowerText, int row, int col, Direction dir) {
         PlacedWord pw;
-        pw.text = firstWord;
-        pw.startRow = 0;
-        pw.startCol = 0;
-        pw.dir = Direction::Horizontal;
+        pw.wordIndex = wordIndex;
+        pw.length = static_cast<int>(lowerText.size());
+        pw.startRow = row;
+        pw.startCol = col;
+        pw.dir = dir;
         placed.push_back(pw);
-
-        for (int i = 0; i < static_cast<int>(firstWord.size()); ++i) {
-            char ch = static_cast<char>(std::tolower(static_cast<unsigned char>(firstWord[i])));
-            occupiedCells[{0, i}] = ch;
+        const int placedIndex = static_cast<int>(placed.size()) - 1;
+
+        int len = static_cast<int>(lowerText.size());
+        int endR = (dir == Direction::Horizontal) ? row : row + len - 1;
+        int endC = (dir == Direction::Horizontal) ? col + len - 1 : col;
+        minRow = std::min(minRow, row);
+        maxRow = std::max(maxRow, endR);
+        minCol = std::min(minCol, col);
+        maxCol = std::max(maxCol, endC);
+
+        for (int i = 0; i < len; ++i) {
+            int r = (dir == Direction::Horizontal) ? row : row + i;
+            int c = (dir == Direction::Horizontal) ? col + i : col;
+            if (occupiedCells.at(r, c) != '\0') {
+                sharedCells.push_back({ r, c, letterIndex.ownerAt(lowerText[i], r, c), CellOwner{ placedIndex, i } });
+            }
+            else {
+                occupiedCells.set(r, c, lowerText[i]);
+            }
         }
+        letterIndex.addWord(lowerText, row, col, dir, placedIndex);
     }
+};
 
-    std::vector<bool> isPlaced(sortedWords.size(), false);
-    isPlaced[0] = true;
+// CrosswordShape resolved for one word set. With the default shape every term
+// reduces to the classic scoring (and the same floating-point values).
+struct ShapeRules {
+    static constexpr double ASPECT_TOLERANCE = 0.15; // Accepted distance from targetAspect, relative
+    static constexpr double SYMMETRY_WEIGHT = 6.0;    // Per letter that lands opposite another one
+
+    bool classic;
+    double targetAspect;
+    double minAspect;
+    long long maxArea; // 0 = no limit
+    double minIntersectionsPerWord;
+    double minSymmetry;
+    double intersectionWeight;
+
+    ShapeRules(const CrosswordShape& shape, int totalLetters)
+        : classic(shape == CrosswordShape{}),
+          targetAspect(shape.targetAspect),
+          minAspect(shape.minAspect),
+          maxArea(shape.maxAreaPerLetter > 0.0 ? static_cast<long long>(std::ceil(shape.maxAreaPerLetter * totalLetters)) : 0),
+          minIntersectionsPerWord(shape.minIntersectionsPerWord),
+          minSymmetry(shape.minSymmetry),
+          intersectionWeight(shape.minIntersectionsPerWord > 0.0 ? 20.0 : 10.0) {}
+
+    // Hard limits on the bounds a spot would leave
+    bool allows(int rows, int cols) const {
+        return cols >= minAspect * rows && (maxArea == 0 || static_cast<long long>(rows) * cols <= maxArea);
+    }
 
-    int curMinRow = 0, curMaxRow = 0;
-    int curMinCol = 0, curMaxCol = static_cast<int>(sortedWords[0].text.size()) - 1;
+    // Placement preference for those bounds
+    double aspectTerm(int rows, int cols) const {
+        if (targetAspect > 0.0) return -std::abs(cols - targetAspect * rows) * 5.0;
+        return (cols - rows) * 5.0;
+    }
 
-    for (size_t wi = 1; wi < sortedWords.size(); ++wi) {
-        const std::string& candidate = sortedWords[wi].text;
-        std::string lowerCandidate = candidate;
-        std::transform(lowerCandidate.begin(), lowerCandidate.end(), lowerCandidate.begin(),
-            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    // Finished (or partial) layouts; 'symmetry' is only read when minSymmetry > 0
+    double layoutScore(std::size_t placed, int rows, int cols, std::size_t intersections, double symmetry) const {
+        if (classic) return crosswordScore(placed, rows, cols);
+        const double ratio = cols / static_cast<double>(std::max(rows, 1));
+        double score = placed * 1000.0 - rows * 10.0;
+        score += (targetAspect > 0.0) ? -std::abs(ratio - targetAspect) * 100.0 : ratio * 100.0;
+        if (maxArea > 0) score -= static_cast<double>(rows) * cols * 2.0;
+        if (minIntersectionsPerWord > 0.0 && placed > 0) {
+            const double perWord = intersections / static_cast<double>(placed);
+            if (perWord < minIntersectionsPerWord) score -= (minIntersectionsPerWord - perWord) * 400.0;
+        }
+        if (minSymmetry > 0.0) score += symmetry * 300.0;
+        return score;
+    }
 
-        double bestScore = -1.0;
-        int bestRow = 0, bestCol = 0;
-        Direction bestDir = Direction::Horizontal;
-
-        for (size_t pi = 0; pi < placed.size(); ++pi) {
-            const PlacedWord& pw = placed[pi];
-            std::string lowerPlaced = pw.text;
-            std::transform(lowerPlaced.begin(), lowerPlaced.end(), lowerPlaced.begin(),
-                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-
-            Direction newDir = (pw.dir == Direction::Horizontal) ? Direction::Vertical : Direction::Horizontal;
-
-            for (int ci = 0; ci < static_cast<int>(lowerCandidate.size()); ++ci) {
-                for (int pj = 0; pj < static_cast<int>(lowerPlaced.size()); ++pj) {
-                    if (lowerCandidate[ci] != lowerPlaced[pj]) continue;
-
-                    int placedCellR = (pw.dir == Direction::Horizontal) ? pw.startRow : pw.startRow + pj;
-                    int placedCellC = (pw.dir == Direction::Horizontal) ? pw.startCol + pj : pw.startCol;
-
-                    int startRow, startCol;
-                    if (newDir == Direction::Horizontal) {
-                        startRow = placedCellR;
-                        startCol = placedCellC - ci;
-                    } else {
-                        startRow = placedCellR - ci;
-                        startCol = placedCellC;
-                    }
-
-                    int intersections = 0;
-                    if (canPlace(lowerCandidate, startRow, startCol, newDir, occupiedCells, intersections)) {
-                        int candLen = static_cast<int>(lowerCandidate.size());
-                        int endR = (newDir == Direction::Horizontal) ? startRow : startRow + candLen - 1;
-                        int endC = (newDir == Direction::Horizontal) ? startCol + candLen - 1 : startCol;
-                        int newMinR = std::min(curMinRow, startRow);
-                        int newMaxR = std::max(curMaxRow, endR);
-                        int newMinC = std::min(curMinCol, startCol);
-                        int newMaxC = std::max(curMaxCol, endC);
-                        int newRows = newMaxR - newMinR + 1;
-                        int newCols = newMaxC - newMinC + 1;
-
-                        if (newRows > newCols) continue;
-
-                        int widthBonus = (newCols - newRows) * 5;
-                        double randomJitter = jitterDist(rng);
-                        double score = intersections * 10.0 + static_cast<double>(lowerCandidate.size()) + widthBonus + randomJitter;
-                        if (score > bestScore) {
-                            bestScore = score;
-                            bestRow = startRow;
-                            bestCol = startCol;
-                            bestDir = newDir;
-                        }
-                    }
-                }
+    // Good enough to stop searching once every word is placed
+    bool accepts(int rows, int cols, std::size_t placed, std::size_t intersections, double symmetry, double acceptAspect) const {
+        const double ratio = cols / static_cast<double>(std::max(rows, 1));
+        if (targetAspect > 0.0 ? std::abs(ratio - targetAspect) > targetAspect * ASPECT_TOLERANCE : ratio < acceptAspect) return false;
+        if (placed > 0 && intersections / static_cast<double>(placed) < minIntersectionsPerWord) return false;
+        return minSymmetry <= 0.0 || symmetry >= minSymmetry;
+    }
+};
+
+// A legal spot for a word on a board, with the bounds it would produce
+struct PlacementOption {
+    int row;
+    int col;
+    Direction dir;
+    int intersections;
+    int rows;
+    int cols;
+};
+
+// Enumerates the legal spots for a word (crossing at least one letter, within the
+// shape's hard limits). Keeps its match buffers between calls.
+class PlacementFinder {
+public:
+    // Calls fn(option) in (placed word, candidate letter, placed letter) order, the order
+    // a scan over every placed word would use; the greedy jitter draws and ties depend on it.
+    template <typename Fn>
+    void forEach(const Board& board, const std::string& lowerCandidate, const ShapeRules& rules, Fn&& fn) {
+        // Collected by candidate letter, then stably bucketed by placed word
+        m_found.clear();
+        m_matchStarts.assign(board.placed.size() + 1, 0);
+        for (int ci = 0; ci < static_cast<int>(lowerCandidate.size()); ++ci) {
+            const int bucket = LetterIndex::bucketFor(lowerCandidate[ci]);
+            for (const Anchor& anchor : board.letterIndex.anchors(bucket)) {
+                if (bucket == LetterIndex::OTHER_BUCKET && anchor.letter != lowerCandidate[ci]) continue;
+                m_found.push_back({ &anchor, ci });
+                ++m_matchStarts[anchor.placedIndex + 1];
             }
         }
-
-        if (bestScore > 0) {
-            PlacedWord pw;
-            pw.text = candidate;
-            pw.startRow = bestRow;
-            pw.startCol = bestCol;
-            pw.dir = bestDir;
-            placed.push_back(pw);
-            isPlaced[wi] = true;
-
-            int candLen = static_cast<int>(lowerCandidate.size());
-            int endR = (bestDir == Direction::Horizontal) ? bestRow : bestRow + candLen - 1;
-            int endC = (bestDir == Direction::Horizontal) ? bestCol + candLen - 1 : bestCol;
-            curMinRow = std::min(curMinRow, bestRow);
-            curMaxRow = std::max(curMaxRow, endR);
-            curMinCol = std::min(curMinCol, bestCol);
-            curMaxCol = std::max(curMaxCol, endC);
-
-            for (int i = 0; i < static_cast<int>(lowerCandidate.size()); ++i) {
-                int r = (bestDir == Direction::Horizontal) ? bestRow : bestRow + i;
-                int c = (bestDir == Direction::Horizontal) ? bestCol + i : bestCol;
-                char ch = static_cast<char>(std::tolower(static_cast<unsigned char>(candidate[i])));
-                occupiedCells[{r, c}] = ch;
+        for (std::size_t pi = 1; pi < m_matchStarts.size(); ++pi) m_matchStarts[pi] += m_matchStarts[pi - 1];
+        m_matches.resize(m_found.size());
+        for (const Match& match : m_found) m_matches[m_matchStarts[match.anchor->placedIndex]++] = match;
+
+        const int candLen = static_cast<int>(lowerCandidate.size());
+        for (const Match& match : m_matches) {
+            const int ci = match.candidateIndex;
+            const Direction newDir = (match.anchor->dir == Direction::Horizontal) ? Direction::Vertical : Direction::Horizontal;
+
+            int startRow, startCol;
+            if (newDir == Direction::Horizontal) {
+                startRow = match.anchor->row;
+                startCol = match.anchor->col - ci;
+            } else {
+                startRow = match.anchor->row - ci;
+                startCol = match.anchor->col;
             }
+
+            // Bounds first: they are cheaper than the letter checks and prune most spots
+            // under a tight shape
+            int endR = (newDir == Direction::Horizontal) ? startRow : startRow + candLen - 1;
+            int endC = (newDir == Direction::Horizontal) ? startCol + candLen - 1 : startCol;
+            int newRows = std::max(board.maxRow, endR) - std::min(board.minRow, startRow) + 1;
+            int newCols = std::max(board.maxCol, endC) - std::min(board.minCol, startCol) + 1;
+            if (!rules.allows(newRows, newCols)) continue;
+
+            int intersections = 0;
+            if (!canPlace(lowerCandidate, startRow, startCol, newDir, board.occupiedCells, intersections)) continue;
+
+            fn(PlacementOption{ startRow, startCol, newDir, intersections, newRows, newCols });
         }
     }
 
-    int minRow = INT_MAX, minCol = INT_MAX;
-    int maxRow = INT_MIN, maxCol = INT_MIN;
+private:
+    // (anchor, candidate letter) pairs sharing a letter
+    struct Match { const Anchor* anchor; int candidateIndex; };
+    std::vector<Match> m_found, m_matches;
+    std::vector<int> m_matchStarts;
+};
 
-    for (const auto& pw : placed) {
-        int endRow = (pw.dir == Direction::Horizontal) ? pw.startRow : pw.startRow + static_cast<int>(pw.text.size()) - 1;
-        int endCol = (pw.dir == Direction::Horizontal) ? pw.startCol + static_cast<int>(pw.text.size()) - 1 : pw.startCol;
-        minRow = std::min(minRow, pw.startRow);
-        minCol = std::min(minCol, pw.startCol);
-        maxRow = std::max(maxRow, endRow);
-        maxCol = std::max(maxCol, endCol);
+// Letters of a spot that would sit opposite another letter (180-degree rotation
+// within the bounds the spot leaves), for the symmetry goal
+int mirroredLetters(const Board& board, int length, const PlacementOption& option) {
+    const int minRow = std::min(board.minRow, option.row);
+    const int minCol = std::min(board.minCol, option.col);
+    const int rowSum = 2 * minRow + option.rows - 1;
+    const int colSum = 2 * minCol + option.cols - 1;
+    const bool across = option.dir == Direction::Horizontal;
+    int hits = 0;
+    for (int i = 0; i < length; ++i) {
+        const int r = across ? option.row : option.row + i;
+        const int c = across ? option.col + i : option.col;
+        const int mr = rowSum - r, mc = colSum - c;
+        const bool onWord = across ? (mr == option.row && mc >= option.col && mc < option.col + length)
+                                   : (mc == option.col && mr >= option.row && mr < option.row + length);
+        if (onWord || board.occupiedCells.at(mr, mc) != '\0') ++hits;
     }
+    return hits;
+}
 
-    result.gridRows = maxRow - minRow + 1;
-    result.gridCols = maxCol - minCol + 1;
+// Shifts a finished board to (0, 0) and fills in the words and shared cells.
+// Everything is read from the board's bookkeeping: O(words + intersections).
+CrosswordResult assembleResult(const TrialWords& trial, const Board& board) {
+    CrosswordResult result;
+    result.gridRows = board.maxRow - board.minRow + 1;
+    result.gridCols = board.maxCol - board.minCol + 1;
 
-    for (size_t i = 0; i < placed.size(); ++i) {
-        const PlacedWord& pw = placed[i];
+    result.placements.reserve(board.placed.size());
+    result.placedIndices.reserve(board.placed.size());
+    for (const PlacedWord& pw : board.placed) {
         CrosswordPlacement cp;
-        cp.gridRow = pw.startRow - minRow;
-        cp.gridCol = pw.startCol - minCol;
+        cp.gridRow = pw.startRow - board.minRow;
+        cp.gridCol = pw.startCol - board.minCol;
         cp.dir = pw.dir;
         result.placements.push_back(cp);
+        result.placedIndices.push_back(trial.order[pw.wordIndex]);
+    }
 
-        for (const auto& wi : sortedWords) {
-            std::string lowerWi = wi.text;
-            std::transform(lowerWi.begin(), lowerWi.end(), lowerWi.begin(),
-                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-            std::string lowerPw = pw.text;
-            std::transform(lowerPw.begin(), lowerPw.end(), lowerPw.begin(),
-                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-            if (lowerWi == lowerPw) {
-                result.placedWords.push_back(wi);
-                break;
+    for (const SharedCell& shared : board.sharedCells) {
+        result.sharedCells[{ shared.row - board.minRow, shared.col - board.minCol }] = { shared.first, shared.second };
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// Greedy: each word goes to its best-scoring spot (plus jitter), never revisited
+static CrosswordResult generateCrosswordTrial(const CrosswordWords& words, std::mt19937& rng, const CrosswordShape& shape) {
+    if (words.empty()) return CrosswordResult{};
+
+    const TrialWords trial = prepareTrialWords(words, rng);
+    const ShapeRules rules(shape, trial.totalLetters);
+    std::uniform_real_distribution<double> jitterDist(0.0, 4.0);
+
+    Board board(trial);
+    PlacementFinder finder;
+
+    for (size_t wi = 1; wi < trial.order.size(); ++wi) {
+        const std::string& lowerCandidate = trial.lower[wi];
+        const int candLen = static_cast<int>(lowerCandidate.size());
+
+        bool found = false;
+        double bestScore = 0.0;
+        PlacementOption best{};
+        finder.forEach(board, lowerCandidate, rules, [&](const PlacementOption& option) {
+            double shapeBonus = rules.aspectTerm(option.rows, option.cols);
+            if (rules.minSymmetry > 0.0) shapeBonus += mirroredLetters(board, candLen, option) * ShapeRules::SYMMETRY_WEIGHT;
+            double randomJitter = jitterDist(rng);
+            double score = option.intersections * rules.intersectionWeight + static_cast<double>(candLen) + shapeBonus + randomJitter;
+            if (!found || score > bestScore) {
+                found = true;
+                bestScore = score;
+                best = option;
             }
+        });
+
+        if (found) {
+            board.place(static_cast<int>(wi), lowerCandidate, best.row, best.col, best.dir);
         }
     }
 
-    std::map<std::pair<int,int>, std::vector<std::pair<int,int>>> cellOwners;
+    return assembleResult(trial, board);
+}
 
-    for (size_t wi = 0; wi < result.placements.size(); ++wi) {
-        const CrosswordPlacement& cp = result.placements[wi];
-        const std::string& word = result.placedWords[wi].text;
+// Beam search: keeps the 'beamWidth' best partial layouts after each word instead of
+// committing to one spot, so an early placement that blocks a later word can be
+// outgrown by a sibling. A word is skipped on a board only where it fits nowhere.
+static CrosswordResult generateCrosswordBeamTrial(const CrosswordWords& words, std::mt19937& rng, int beamWidth,
+    const CrosswordShape& shape) {
+    if (words.empty()) return CrosswordResult{};
+
+    const TrialWords trial = prepareTrialWords(words, rng);
+    const ShapeRules rules(shape, trial.totalLetters);
+    std::uniform_real_distribution<double> jitterDist(0.0, 4.0);
+    const std::size_t width = static_cast<std::size_t>(std::max(beamWidth, 1));
+    const std::size_t wordCount = trial.order.size();
 
-        for (int ci = 0; ci < static_cast<int>(word.size()); ++ci) {
-            int r = (cp.dir == Direction::Horizontal) ? cp.gridRow : cp.gridRow + ci;
-            int c = (cp.dir == Direction::Horizontal) ? cp.gridCol + ci : cp.gridCol;
-            cellOwners[{r, c}].push_back({static_cast<int>(wi), ci});
+    // Letter sets for the compatibility bound
+    std::vector<std::uint32_t> letterMasks(wordCount, 0);
+    for (std::size_t wi = 0; wi < wordCount; ++wi) {
+        for (char ch : trial.lower[wi]) letterMasks[wi] |= 1u << LetterIndex::bucketFor(ch);
+    }
+
+    struct State {
+        Board board;
+        int intersections = 0;
+        std::uint32_t boardLetters = 0;
+        std::uint64_t signature = 0; // Order-independent hash of the placements, for de-duplication
+    };
+    struct Child {
+        std::size_t parent;
+        bool skip;
+        PlacementOption option;
+        double rank;
+        std::uint64_t signature;
+    };
+
+    std::vector<State> beam;
+    beam.push_back({ Board(trial), 0, letterMasks[0], mixSeed(0) });
+    PlacementFinder finder;
+    std::vector<Child> children;
+    std::vector<std::uint32_t> lettersBefore;
+
+    for (std::size_t wi = 1; wi < wordCount; ++wi) {
+        const std::string& lowerCandidate = trial.lower[wi];
+
+        // Letters the words between this one and each later word could bring to the board
+        // (words are placed in order, so a later word can only cross those or the board)
+        lettersBefore.assign(wordCount, 0);
+        for (std::size_t later = wi + 2; later < wordCount; ++later) {
+            lettersBefore[later] = lettersBefore[later - 1] | letterMasks[later - 1];
         }
+
+        children.clear();
+        int mostPlaced = 0;
+        for (std::size_t p = 0; p < beam.size(); ++p) {
+            const State& state = beam[p];
+            const int placed = static_cast<int>(state.board.placed.size());
+            bool fits = false;
+            finder.forEach(state.board, lowerCandidate, rules, [&](const PlacementOption& option) {
+                fits = true;
+                double shapeBonus = rules.aspectTerm(option.rows, option.cols);
+                if (rules.minSymmetry > 0.0) {
+                    shapeBonus += mirroredLetters(state.board, static_cast<int>(lowerCandidate.size()), option) * ShapeRules::SYMMETRY_WEIGHT;
+                }
+                const double rank = (placed + 1) * 1000.0 + (state.intersections + option.intersections) * rules.intersectionWeight
+                    + shapeBonus + jitterDist(rng);
+                const std::uint64_t placement = (static_cast<std::uint64_t>(wi) << 42)
+                    ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(option.row)) << 21)
+                    ^ static_cast<std::uint64_t>(static_cast<std::uint32_t>(option.col)) ^ (option.dir == Direction::Vertical ? 1ull << 63 : 0);
+                children.push_back({ p, false, option, rank, state.signature ^ mixSeed(placement) });
+            });
+            if (!fits) {
+                const int rows = state.board.maxRow - state.board.minRow + 1;
+                const int cols = state.board.maxCol - state.board.minCol + 1;
+                const double rank = placed * 1000.0 + state.intersections * rules.intersectionWeight
+                    + rules.aspectTerm(rows, cols) + jitterDist(rng);
+                children.push_back({ p, true, PlacementOption{}, rank, state.signature });
+            }
+            mostPlaced = std::max(mostPlaced, placed + (fits ? 1 : 0));
+        }
+
+        // Prune children that cannot catch up with the leader even if every remaining
+        // word that shares a letter with what could be on the board by then fits
+        auto upperBound = [&](const Child& child) {
+            const State& parent = beam[child.parent];
+            const std::uint32_t letters = parent.boardLetters | (child.skip ? 0u : letterMasks[wi]);
+            int bound = static_cast<int>(parent.board.placed.size()) + (child.skip ? 0 : 1);
+            for (std::size_t later = wi + 1; later < wordCount; ++later) {
+                if (letterMasks[later] & (letters | lettersBefore[later])) ++bound;
+            }
+            return bound;
+        };
+        children.erase(std::remove_if(children.begin(), children.end(),
+            [&](const Child& child) { return upperBound(child) < mostPlaced; }), children.end());
+
+        // Best first; equal ranks keep enumeration order so the result only depends on the seed
+        std::stable_sort(children.begin(), children.end(),
+            [](const Child& a, const Child& b) { return a.rank > b.rank; });
+
+        std::vector<State> next;
+        next.reserve(width);
+        std::vector<std::uint64_t> taken;
+        for (const Child& child : children) {
+            if (next.size() == width) break;
+            if (std::find(taken.begin(), taken.end(), child.signature) != taken.end()) continue;
+            taken.push_back(child.signature);
+
+            State state = beam[child.parent];
+            if (!child.skip) {
+                state.board.place(static_cast<int>(wi), lowerCandidate, child.option.row, child.option.col, child.option.dir);
+                state.intersections += child.option.intersections;
+                state.boardLetters |= letterMasks[wi];
+                state.signature = child.signature;
+            }
+            next.push_back(std::move(state));
+        }
+        beam = std::move(next);
     }
 
-    for (const auto& pair : cellOwners) {
-        if (pair.second.size() > 1) {
-            result.sharedCells[pair.first] = pair.second;
+    // Final pick with the same score generateCrossword uses between trials
+    const State* best = &beam[0];
+    double bestScore = -1e9;
+    for (const State& state : beam) {
+        const double symmetry = (rules.minSymmetry > 0.0) ? crosswordSymmetry(assembleResult(trial, state.board), words) : 0.0;
+        const double score = rules.layoutScore(state.board.placed.size(), state.board.maxRow - state.board.minRow + 1,
+            state.board.maxCol - state.board.minCol + 1, state.board.sharedCells.size(), symmetry);
+        if (score > bestScore) {
+            bestScore = score;
+            best = &state;
         }
     }
+    return assembleResult(trial, best->board);
+}
 
-    return result;
+void CrosswordCellTable::build(const std::vector<CrosswordPlacement>& placements, const std::vector<WordId>& words,
+    const std::vector<WordInfo>& wordList, int gridRows, int gridCols) {
+    clear();
+    if (gridRows <= 0 || gridCols <= 0) return;
+    m_cells.resize(static_cast<std::size_t>(gridRows) * gridCols);
+    m_words.resize(std::min(placements.size(), words.size()));
+
+    for (std::size_t wi = 0; wi < m_words.size(); ++wi) {
+        const CrosswordPlacement& p = placements[wi];
+        const std::string& text = wordList[words[wi]].text;
+        const int length = static_cast<int>(text.size());
+        const bool across = p.dir == Direction::Horizontal;
+        const int endRow = across ? p.gridRow : p.gridRow + length - 1;
+        const int endCol = across ? p.gridCol + length - 1 : p.gridCol;
+        if (p.gridRow < 0 || p.gridCol < 0 || endRow >= gridRows || endCol >= gridCols) {
+            std::cerr << "ERROR: Crossword word " << wi << " ('" << text << "') lies outside the "
+                << gridRows << "x" << gridCols << " grid." << std::endl;
+            continue; // Left with length 0, so cellOf() rejects it
+        }
+
+        WordCells& w = m_words[wi];
+        w.start = p.gridRow * gridCols + p.gridCol;
+        w.stride = across ? 1 : gridCols;
+        w.length = length;
+        for (int ci = 0; ci < length; ++ci) {
+            Cell& cell = m_cells[static_cast<std::size_t>(w.start + ci * w.stride)];
+            if (cell.count < 2) cell.owners[cell.count++] = { static_cast<int>(wi), ci };
+            else std::cerr << "ERROR: More than two crossword words cover one cell (word " << wi << ")." << std::endl;
+        }
+    }
 }
 
-CrosswordResult generateCrossword(const std::vector<WordInfo>& words) {
+
+void CrosswordCellTable::clear() {
+    m_cells.clear();
+    m_words.clear();
+}
+
+
+double crosswordScore(std::size_t placedWords, int gridRows, int gridCols) {
+    double ratio = gridCols / static_cast<double>(std::max(gridRows, 1));
+    return placedWords * 1000.0 + ratio * 100.0 - gridRows * 10.0;
+}
+
+
+CrosswordWords::CrosswordWords(const std::vector<WordInfo>& words) {
+    m_words.reserve(words.size());
+    for (const WordInfo& info : words) m_words.push_back(&info);
+}
+
+
+CrosswordWords::CrosswordWords(const std::vector<WordId>& ids, const std::vector<WordInfo>& wordList) {
+    m_words.reserve(ids.size());
+    for (WordId id : ids) m_words.push_back(&wordList[id]);
+}
+
+
+double crosswordSymmetry(const CrosswordResult& result, const CrosswordWords& words) {
+    if (result.gridRows <= 0 || result.gridCols <= 0) return 0.0;
+    std::vector<char> occupied(static_cast<std::size_t>(result.gridRows) * result.gridCols, 0);
+    for (std::size_t wi = 0; wi < result.placements.size(); ++wi) {
+        const CrosswordPlacement& cp = result.placements[wi];
+        const int len = static_cast<int>(words.text(result.placedIndices[wi]).size());
+        for (int i = 0; i < len; ++i) {
+            const int r = (cp.dir == Direction::Horizontal) ? cp.gridRow : cp.gridRow + i;
+            const int c = (cp.dir == Direction::Horizontal) ? cp.gridCol + i : cp.gridCol;
+            occupied[static_cast<std::size_t>(r) * result.gridCols + c] = 1;
+        }
+    }
+    int letters = 0, matched = 0;
+    const std::size_t last = occupied.size() - 1;
+    for (std::size_t i = 0; i < occupied.size(); ++i) {
+        if (!occupied[i]) continue;
+        ++letters;
+        if (occupied[last - i]) ++matched;
+    }
+    return letters > 0 ? matched / static_cast<double>(letters) : 0.0;
+}
+
+
+CrosswordShape crosswordShape(CrosswordShapePreset preset) {
+    CrosswordShape shape;
+    switch (preset) {
+    case CrosswordShapePreset::Wide:
+        break;
+    case CrosswordShapePreset::Balanced:
+        shape.targetAspect = 1.6;
+        break;
+    case CrosswordShapePreset::Compact:
+        shape.targetAspect = 1.6;
+        shape.maxAreaPerLetter = 2.2;
+        break;
+    case CrosswordShapePreset::Dense:
+        shape.minIntersectionsPerWord = 1.0;
+        break;
+    case CrosswordShapePreset::Symmetric:
+        shape.minSymmetry = 0.55;
+        break;
+    }
+    return shape;
+}
+
+
+bool crosswordShapeFromName(const std::string& name, CrosswordShape& shape) {
+    static const std::pair<const char*, CrosswordShapePreset> NAMES[] = {
+        { "wide", CrosswordShapePreset::Wide },
+        { "balanced", CrosswordShapePreset::Balanced },
+        { "compact", CrosswordShapePreset::Compact },
+        { "dense", CrosswordShapePreset::Dense },
+        { "symmetric", CrosswordShapePreset::Symmetric },
+    };
+    for (const auto& entry : NAMES) {
+        if (name == entry.first) {
+            shape = crosswordShape(entry.second);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+CrosswordResult generateCrossword(const CrosswordWords& words, std::uint64_t seed,
+    const CrosswordOptions& options) {
     if (words.empty()) return CrosswordResult{};
 
-    std::random_device rd;
-    std::mt19937 rng(rd());
+    CrosswordCache* cache = (options.shape == CrosswordShape{}) ? options.cache : nullptr;
+    if (cache) {
+        CrosswordResult cached;
+        if (cache->lookup(words, cached)) {
+            if (!options.quiet) {
+                std::cout << "Crossword: using cached " << cached.gridRows << "x" << cached.gridCols << " layout of "
+                          << cached.placedIndices.size() << " of " << words.size() << " words." << std::endl;
+            }
+            return cached;
+        }
+    }
+
+    int totalLetters = 0;
+    for (std::size_t i = 0; i < words.size(); ++i) totalLetters += static_cast<int>(words.text(i).size());
+    const ShapeRules rules(options.shape, totalLetters);
 
-    const int NUM_TRIALS = 20;
+    const auto startTime = std::chrono::steady_clock::now();
+    const int maxTrials = std::max(options.maxTrials, 1);
+    // One round keeps every pool thread (and the caller) busy
+    const int roundSize = static_cast<int>(ThreadPool::shared().size()) + 1;
+
+    // Trials are independent: each runs on the shared pool with its own stream
+    std::vector<CrosswordResult> round;
     CrosswordResult bestResult;
     double bestScore = -1e9;
+    int trialsUsed = 0;
+    const char* stopReason = "trial budget";
+
+    // Rounds only decide how far ahead trials run; results are taken strictly in
+    // trial order, so the chosen layout does not depend on the core count.
+    while (trialsUsed < maxTrials) {
+        if (trialsUsed > 0 && options.timeBudgetMs > 0.0 &&
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= options.timeBudgetMs) {
+            stopReason = "time budget";
+            break;
+        }
 
-    for (int trial = 0; trial < NUM_TRIALS; ++trial) {
-        CrosswordResult result = generateCrosswordTrial(words, rng);
-        int placed = static_cast<int>(result.placedWords.size());
-        double ratio = result.gridCols / static_cast<double>(std::max(result.gridRows, 1));
-        double score = placed * 1000.0 + ratio * 100.0 - result.gridRows * 10.0;
-        if (score > bestScore) {
-            bestScore = score;
-            bestResult = std::move(result);
+        const int first = trialsUsed;
+        round.assign(static_cast<std::size_t>(std::min(roundSize, maxTrials - first)), CrosswordResult{});
+        ThreadPool::shared().parallelFor(round.size(), [&](std::size_t i) {
+            std::mt19937 rng = seededRng(deriveSeed(seed, first + i));
+            round[i] = (options.engine == CrosswordEngine::Beam)
+                ? generateCrosswordBeamTrial(words, rng, options.beamWidth, options.shape)
+                : generateCrosswordTrial(words, rng, options.shape);
+        });
+
+        bool accepted = false;
+        for (CrosswordResult& result : round) {
+            ++trialsUsed;
+            double symmetry = (rules.minSymmetry > 0.0) ? crosswordSymmetry(result, words) : 0.0;
+            double score = rules.layoutScore(result.placedIndices.size(), result.gridRows, result.gridCols,
+                result.sharedCells.size(), symmetry);
+            accepted = result.placedIndices.size() == words.size() && rules.accepts(result.gridRows, result.gridCols,
+                result.placedIndices.size(), result.sharedCells.size(), symmetry, options.acceptAspect);
+            if (score > bestScore) {
+                bestScore = score;
+                bestResult = std::move(result);
+            }
+            if (accepted) {
+                stopReason = "accepted";
+                break;
+            }
         }
+        if (accepted) break;
+    }
+    bestResult.trialsUsed = trialsUsed;
+    if (cache) cache->offer(words, bestResult);
+
+    if (!options.quiet) {
+        std::cout << "Crossword: placed " << bestResult.placedIndices.size()
+                  << " of " << words.size() << " words into a "
+                  << bestResult.gridRows << "x" << bestResult.gridCols << " grid with "
+                  << bestResult.sharedCells.size() << " intersections"
+                  << " (best of " << trialsUsed << " trials, stopped by " << stopReason << ")." << std::endl;
     }
-
-    std::cout << "Crossword: placed " << bestResult.placedWords.size()
-              << " of " << words.size() << " words into a "
-              << bestResult.gridRows << "x" << bestResult.gridCols << " grid with "
-              << bestResult.sharedCells.size() << " intersections"
-              << " (best of " << NUM_TRIALS << " trials)." << std::endl;
 
     return bestResult;
 }
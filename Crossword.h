@@ -2,10 +2,15 @@
 #ifndef CROSSWORD_H
 #define CROSSWORD_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <map>
+#include <string>
 #include <utility>
-#include "GameData.h"
+#include "WordInfo.h"
+
+class CrosswordCache;
 
 enum class Direction { Horizontal, Vertical };
 
@@ -15,14 +20,136 @@ struct CrosswordPlacement {
     Direction dir = Direction::Horizontal;
 };
 
+// The words to lay out, by reference: a WordInfo list, or ids into a word list.
+// Only pointers are kept, so the words must outlive it unchanged.
+class CrosswordWords {
+public:
+    CrosswordWords(const std::vector<WordInfo>& words); // Implicit, so WordInfo lists pass as they are
+    CrosswordWords(const std::vector<WordId>& ids, const std::vector<WordInfo>& wordList);
+
+    std::size_t size() const { return m_words.size(); }
+    bool empty() const { return m_words.empty(); }
+    const std::string& text(std::size_t i) const { return m_words[i]->text; }
+
+private:
+    std::vector<const WordInfo*> m_words;
+};
+
 struct CrosswordResult {
-    std::vector<WordInfo> placedWords;
-    std::vector<CrosswordPlacement> placements;
+    std::vector<std::size_t> placedIndices; // Position of each placed word in the input words
+    std::vector<CrosswordPlacement> placements; // Parallel to placedIndices
     std::map<std::pair<int, int>, std::vector<std::pair<int, int>>> sharedCells;
     int gridRows = 0;
     int gridCols = 0;
+    int trialsUsed = 0; // Trials the layout was chosen from
+    bool fromCache = false;
+};
+
+// How each trial lays out the words
+enum class CrosswordEngine {
+    Greedy, // Each word at its best spot, never revisited (fast)
+    Beam    // Beam search over partial layouts (slower per trial, drops fewer words)
+};
+
+// What a good layout looks like. Spots that break a hard limit are skipped while
+// placing; the soft goals steer placement and decide between finished layouts.
+// The default is the classic rule: as wide as possible, never taller than wide.
+struct CrosswordShape {
+    double targetAspect = 0.0;            // cols/rows to aim for; 0 = the wider the better
+    double minAspect = 1.0;               // Hard: the grid never gets narrower than this (cols/rows)
+    double maxAreaPerLetter = 0.0;        // Hard: rows*cols at most this times the words' letters, 0 = no limit
+    double minIntersectionsPerWord = 0.0; // Soft: crossings are favoured until layouts reach this
+    double minSymmetry = 0.0;             // Soft: share of letter cells matched under 180-degree rotation
+
+    bool operator==(const CrosswordShape& other) const {
+        return targetAspect == other.targetAspect && minAspect == other.minAspect
+            && maxAreaPerLetter == other.maxAreaPerLetter && minIntersectionsPerWord == other.minIntersectionsPerWord
+            && minSymmetry == other.minSymmetry;
+    }
+};
+
+enum class CrosswordShapePreset {
+    Wide,      // The default shape
+    Balanced,  // Close to 1.6:1
+    Compact,   // Area capped near the letter count, balanced aspect
+    Dense,     // More crossings per word
+    Symmetric  // Rotational symmetry where the words allow it
 };
 
-CrosswordResult generateCrossword(const std::vector<WordInfo>& words);
+CrosswordShape crosswordShape(CrosswordShapePreset preset);
+// "wide", "balanced", "compact", "dense" or "symmetric" -> 'shape'. False for other names.
+bool crosswordShapeFromName(const std::string& name, CrosswordShape& shape);
+
+// Search budget and engine for generateCrossword
+struct CrosswordOptions {
+    CrosswordEngine engine = CrosswordEngine::Greedy;
+    int beamWidth = 8;          // Partial layouts kept per word (Beam only)
+    int maxTrials = 20;         // Iteration budget
+    double timeBudgetMs = 0.0;  // Wall-clock budget, 0 = none. Checked between rounds of parallel trials
+    double acceptAspect = 2.5;  // Stop early once a trial places every word with cols/rows at least this
+                                // (with a target aspect: within 15% of it, and the shape's soft goals met)
+    CrosswordShape shape;
+    CrosswordCache* cache = nullptr; // When set: a cached layout is returned as is, a new one is offered to it.
+                                     // Only used with the default shape (the cache compares with crosswordScore)
+    bool quiet = false;         // No "Crossword: ..." summary on std::cout (background searches report on the caller's thread)
+};
+
+// How layouts are compared with the default shape: placed words first, then wide and low grids
+double crosswordScore(std::size_t placedWords, int gridRows, int gridCols);
+inline double crosswordScore(const CrosswordResult& result) {
+    return crosswordScore(result.placedIndices.size(), result.gridRows, result.gridCols);
+}
+
+// Dense row-major view of a finished layout for per-letter lookups during play.
+// Every letter maps to its cell with array arithmetic, and each cell lists the
+// (word, letter) pairs covering it inline: two at most, since only words in
+// different directions may cross.
+class CrosswordCellTable {
+public:
+    struct Owner {
+        int word = -1;
+        int letter = -1;
+    };
+    struct Cell {
+        std::uint8_t count = 0;
+        Owner owners[2];
+    };
+
+    // 'words' is parallel to 'placements': the placed words as ids into 'wordList'
+    void build(const std::vector<CrosswordPlacement>& placements, const std::vector<WordId>& words,
+        const std::vector<WordInfo>& wordList, int gridRows, int gridCols);
+    void clear();
+
+    // Cell under letter 'letter' of word 'word'; nullptr when either is out of range
+    const Cell* cellOf(int word, int letter) const {
+        if (word < 0 || static_cast<std::size_t>(word) >= m_words.size()) return nullptr;
+        const WordCells& w = m_words[word];
+        if (letter < 0 || letter >= w.length) return nullptr;
+        return &m_cells[static_cast<std::size_t>(w.start + letter * w.stride)];
+    }
+
+private:
+    struct WordCells {
+        int start = 0;  // Cell index of the first letter
+        int stride = 1; // 1 across, gridCols down
+        int length = 0;
+    };
+
+    std::vector<Cell> m_cells;
+    std::vector<WordCells> m_words;
+};
+
+// Share of letter cells whose 180-degree rotation about the grid centre is also a letter cell.
+// 'words' are the words the layout was made from.
+double crosswordSymmetry(const CrosswordResult& result, const CrosswordWords& words);
+
+// Best of randomized layout trials of options.engine (greedy, or beam search; see
+// CrosswordEngine), searched in rounds until a trial is acceptable or the budget
+// runs out. The layout is the best of trials [0, trialsUsed): without
+// a time budget the same words and seed always give the same layout, and with one
+// the same layout is reproduced by setting maxTrials to trialsUsed. A cache makes the
+// result depend on what it holds (see CrosswordCache.h).
+CrosswordResult generateCrossword(const CrosswordWords& words, std::uint64_t seed,
+    const CrosswordOptions& options = {});
 
 #endif // CROSSWORD_H
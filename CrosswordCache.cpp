@@ -0,0 +1,232 @@
+#include "CrosswordCache.h"
+#include "Seed.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <system_error>
+
+namespace {
+
+    const char* CACHE_HEADER = "#crosswordLayouts v1";
+
+    std::string toLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    // Same cell-owner rule as the generator: owners in placement order
+    void rebuildSharedCells(CrosswordResult& result, const CrosswordWords& words) {
+        std::map<std::pair<int, int>, std::vector<std::pair<int, int>>> cellOwners;
+        for (std::size_t wi = 0; wi < result.placements.size(); ++wi) {
+            const CrosswordPlacement& cp = result.placements[wi];
+            const int len = static_cast<int>(words.text(result.placedIndices[wi]).size());
+            for (int ci = 0; ci < len; ++ci) {
+                int r = (cp.dir == Direction::Horizontal) ? cp.gridRow : cp.gridRow + ci;
+                int c = (cp.dir == Direction::Horizontal) ? cp.gridCol + ci : cp.gridCol;
+                cellOwners[{ r, c }].push_back({ static_cast<int>(wi), ci });
+            }
+        }
+        result.sharedCells.clear();
+        for (auto& pair : cellOwners) {
+            if (pair.second.size() > 1) result.sharedCells.insert(std::move(pair));
+        }
+    }
+
+} // namespace
+
+
+std::uint64_t CrosswordCache::keyFor(const CrosswordWords& words) {
+    std::vector<std::string> texts;
+    texts.reserve(words.size());
+    for (std::size_t i = 0; i < words.size(); ++i) texts.push_back(toLower(words.text(i)));
+    std::sort(texts.begin(), texts.end());
+
+    std::uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (const auto& text : texts) {
+        for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ull; }
+        hash ^= '\n'; hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+bool CrosswordCache::load(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_dirty = false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    if (!std::getline(file, line) || (!line.empty() && line.back() == '\r' ? line.substr(0, line.size() - 1) : line) != CACHE_HEADER) {
+        std::cerr << "Warning: Ignoring crossword cache " << path << " (unknown format)." << std::endl;
+        return false;
+    }
+
+    std::size_t lineNumber = 1;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line == "\r") continue;
+        std::istringstream in(line);
+        std::uint64_t key = 0;
+        Entry entry;
+        std::size_t count = 0;
+        in >> std::hex >> key >> std::dec >> entry.gridRows >> entry.gridCols >> entry.trials >> count;
+        for (std::size_t i = 0; in && i < count; ++i) {
+            std::string word, dir;
+            CrosswordPlacement cp;
+            in >> word >> cp.gridRow >> cp.gridCol >> dir;
+            cp.dir = (dir == "V") ? Direction::Vertical : Direction::Horizontal;
+            entry.words.push_back(std::move(word));
+            entry.placements.push_back(cp);
+        }
+        if (!in || count == 0 || entry.gridRows <= 0 || entry.gridCols <= 0) {
+            std::cerr << "Warning: Ignoring crossword cache " << path << " (malformed line " << lineNumber << ")." << std::endl;
+            m_entries.clear();
+            return false;
+        }
+        m_entries[key] = std::move(entry);
+    }
+    return true;
+}
+
+
+bool CrosswordCache::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<std::uint64_t> keys;
+    keys.reserve(m_entries.size());
+    for (const auto& pair : m_entries) keys.push_back(pair.first);
+    std::sort(keys.begin(), keys.end()); // Stable file contents for the same cache
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open " << tmpPath << " for writing." << std::endl;
+            return false;
+        }
+        out << CACHE_HEADER << '\n';
+        for (std::uint64_t key : keys) {
+            const Entry& entry = m_entries.at(key);
+            out << std::hex << std::setw(16) << std::setfill('0') << key << std::dec << std::setfill(' ')
+                << ' ' << entry.gridRows << ' ' << entry.gridCols << ' ' << entry.trials << ' ' << entry.words.size();
+            for (std::size_t i = 0; i < entry.words.size(); ++i) {
+                const CrosswordPlacement& cp = entry.placements[i];
+                out << ' ' << entry.words[i] << ' ' << cp.gridRow << ' ' << cp.gridCol << ' '
+                    << (cp.dir == Direction::Vertical ? 'V' : 'H');
+            }
+            out << '\n';
+        }
+        if (!out) {
+            std::cerr << "Error: Failed writing " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cerr << "Error: Could not replace " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+
+bool CrosswordCache::lookup(const CrosswordWords& words, CrosswordResult& out) const {
+    const std::uint64_t key = keyFor(words);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return false;
+    const Entry& entry = it->second;
+
+    // Map the cached texts back onto the caller's words (and guard against a hash collision)
+    CrosswordResult result;
+    result.placedIndices.reserve(entry.words.size());
+    for (const auto& text : entry.words) {
+        std::size_t match = 0;
+        while (match < words.size() && toLower(words.text(match)) != text) ++match;
+        if (match == words.size()) return false;
+        result.placedIndices.push_back(match);
+    }
+    result.placements = entry.placements;
+    result.gridRows = entry.gridRows;
+    result.gridCols = entry.gridCols;
+    result.trialsUsed = static_cast<int>(std::min<long long>(entry.trials, std::numeric_limits<int>::max()));
+    result.fromCache = true;
+    rebuildSharedCells(result, words);
+
+    out = std::move(result);
+    return true;
+}
+
+
+bool CrosswordCache::offer(const CrosswordWords& words, const CrosswordResult& result) {
+    if (result.fromCache || result.placedIndices.empty()) return false;
+    for (std::size_t index : result.placedIndices) {
+        const std::string& text = words.text(index);
+        if (text.empty() || std::any_of(text.begin(), text.end(),
+            [](unsigned char c) { return std::isspace(c) != 0; })) {
+            return false; // Would not survive the text format
+        }
+    }
+
+    const std::uint64_t key = keyFor(words);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[key];
+    entry.trials += result.trialsUsed;
+    m_dirty = true;
+
+    const bool isNew = entry.words.empty();
+    if (!isNew && crosswordScore(result) <= crosswordScore(entry.words.size(), entry.gridRows, entry.gridCols)) {
+        return false;
+    }
+    entry.gridRows = result.gridRows;
+    entry.gridCols = result.gridCols;
+    entry.placements = result.placements;
+    entry.words.clear();
+    for (std::size_t index : result.placedIndices) entry.words.push_back(toLower(words.text(index)));
+    return true;
+}
+
+
+bool CrosswordCache::improve(const CrosswordWords& words, int trials, CrosswordOptions options) {
+    if (words.empty() || trials <= 0) return false;
+    const std::uint64_t key = keyFor(words);
+    long long searched = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) searched = it->second.trials;
+    }
+
+    options.cache = nullptr; // Search even though a layout is cached
+    options.shape = CrosswordShape{}; // What the cache compares layouts by
+    options.maxTrials = trials;
+    options.acceptAspect = std::numeric_limits<double>::infinity(); // Use the whole budget
+    CrosswordResult result = generateCrossword(words, deriveSeed(key, static_cast<std::uint64_t>(searched)), options);
+    return offer(words, result);
+}
+
+
+std::size_t CrosswordCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+
+bool CrosswordCache::isDirty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dirty;
+}
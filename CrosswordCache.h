@@ -0,0 +1,64 @@
+#pragma once
+#ifndef CROSSWORDCACHE_H
+#define CROSSWORDCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Crossword.h"
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Persistent crossword layout cache
+//--------------------------------------------------------------------
+// Best layout found so far per word set, keyed by a hash of the sorted lowercase
+// words. generateCrossword returns a cached layout without searching (see
+// CrosswordOptions::cache) and offers every new one; improve() spends spare time
+// on more trials for a word set.
+//
+// File format (text, one layout per line after the header; shared cells are
+// rebuilt from the placements on load):
+//   #crosswordLayouts v1
+//   <key hex> <rows> <cols> <trials searched> <word count> <word> <row> <col> <H|V> ...
+//
+// All members are thread-safe.
+class CrosswordCache {
+public:
+    static std::uint64_t keyFor(const CrosswordWords& words);
+
+    // Replaces the contents with 'path'. False (and empty) when it is missing or
+    // malformed; a malformed file is reported.
+    bool load(const std::string& path);
+    // Writes through a temporary file. False on I/O failure.
+    bool save(const std::string& path) const;
+
+    // Fills 'out' with the cached layout for exactly this word set
+    bool lookup(const CrosswordWords& words, CrosswordResult& out) const;
+    // Keeps 'result' when it beats the cached layout (or none is cached).
+    // Its trials count towards the word set either way. True when stored.
+    bool offer(const CrosswordWords& words, const CrosswordResult& result);
+    // Runs 'trials' more trials for the word set (continuing the seed sequence of
+    // earlier improvements) and offers the best. True when the cache improved.
+    bool improve(const CrosswordWords& words, int trials, CrosswordOptions options);
+
+    std::size_t size() const;
+    bool isDirty() const; // Changed since the last load/save
+
+private:
+    struct Entry {
+        int gridRows = 0;
+        int gridCols = 0;
+        long long trials = 0;
+        std::vector<std::string> words; // Lowercase, parallel to 'placements'
+        std::vector<CrosswordPlacement> placements;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::uint64_t, Entry> m_entries;
+    mutable bool m_dirty = false;
+};
+
+#endif // CROSSWORDCACHE_H
@@ -8,7 +8,6 @@
 #include <stdexcept> // For std::stof, std::stoi exceptions
 #include <algorithm>
 // <string> and <vector> were duplicated, ensure only one of each at the top level if not for specific reasons
-#include <set>
 #include <functional>
 #include <cmath>
 #include <numeric>
@@ -18,6 +17,7 @@
 #include <limits>
 #include <cctype>
 #include <map>
+#include <chrono>
 
 // 2. SFML Headers (Crucial: Before your project headers that use SFML)
 #include <SFML/Graphics.hpp>
@@ -33,6 +33,8 @@
 #include "GameData.h" // GameData.h might use types from SFML/Graphics.hpp
 #include "Game.h"     // Game.h definitely uses types from SFML/Graphics.hpp
 #include "Words.h"
+#include "CompiledDictionary.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include <vector>
 
@@ -99,21 +101,6 @@ static LRESULT CALLBACK WordPuzzle_CustomWndProc(HWND hWnd, UINT msg, WPARAM wPa
 
 inline float S(const Game* g, float du) { return du * g->m_uiScale; }
 
-// --- START: Anonymous Namespace for Helper Function ---
-namespace { // Anonymous namespace for local helper
-    // Helper function to get sorted, lowercase letters of a word
-    std::string getCanonicalLetters(const std::string& word) {
-        std::string temp = word;
-        // Convert to lowercase
-        std::transform(temp.begin(), temp.end(), temp.begin(),
-            [](unsigned char c) { return std::tolower(c); });
-        // Sort alphabetically
-        std::sort(temp.begin(), temp.end());
-        return temp;
-    }
-} // end anonymous namespace
-// --- END: Anonymous Namespace for Helper Function ---
-
 namespace { // Anonymous namespace for helper struct
     struct PopupDrawItem {
         std::string textDisplay; // Actual text to show ('word' or '***')
@@ -428,6 +415,14 @@ Game::Game() :
     m_updateLayout(m_window.getSize());
 }
 
+Game::~Game() {
+    m_cancelPuzzlePrefetch(); // The worker reads the word data owned by this object
+    if (m_crosswordImprovement.valid()) m_crosswordImprovement.wait();
+    if (m_crosswordCache.isDirty() && m_crosswordCache.save(CROSSWORD_CACHE_PATH)) {
+        std::cout << "DEBUG: Saved " << m_crosswordCache.size() << " crossword layouts to " << CROSSWORD_CACHE_PATH << std::endl;
+    }
+}
+
 // --- Main Game Loop ---
     void Game::run() {
         while (m_window.isOpen()) {
@@ -479,21 +474,14 @@ void Game::m_updateAnims(float dt)
                         m_grid[a.wordIdx][a.charIdx] = a.ch;
 
                         // Crossword shared-cell propagation
-                        if (m_gameMode == GameMode::Crossword) {
-                            const auto& p = m_crosswordPlacements[a.wordIdx];
-                            int gr = (p.dir == Direction::Horizontal) ? p.gridRow : p.gridRow + a.charIdx;
-                            int gc = (p.dir == Direction::Horizontal) ? p.gridCol + a.charIdx : p.gridCol;
-                            auto it = m_crosswordSharedCells.find({gr, gc});
-                            if (it != m_crosswordSharedCells.end()) {
-                                for (const auto& owner : it->second) {
-                                    int ow = owner.first;
-                                    int oc = owner.second;
-                                    if (ow != a.wordIdx || oc != a.charIdx) {
-                                        if (ow >= 0 && static_cast<size_t>(ow) < m_grid.size() &&
-                                            oc >= 0 && static_cast<size_t>(oc) < m_grid[ow].size()) {
-                                            m_grid[ow][oc] = a.ch;
-                                        }
-                                    }
+                        const CrosswordCellTable::Cell* cell = (m_gameMode == GameMode::Crossword)
+                            ? m_crosswordCells.cellOf(a.wordIdx, a.charIdx) : nullptr;
+                        if (cell) {
+                            for (int o = 0; o < cell->count; ++o) {
+                                const auto& owner = cell->owners[o];
+                                if (owner.word != a.wordIdx && static_cast<size_t>(owner.word) < m_grid.size() &&
+                                    static_cast<size_t>(owner.letter) < m_grid[owner.word].size()) {
+                                    m_grid[owner.word][owner.letter] = a.ch;
                                 }
                             }
                         }
@@ -502,16 +490,10 @@ void Game::m_updateAnims(float dt)
                         m_checkWordCompletion(a.wordIdx);
 
                         // Check completion on all words sharing this cell
-                        if (m_gameMode == GameMode::Crossword) {
-                            const auto& p = m_crosswordPlacements[a.wordIdx];
-                            int gr = (p.dir == Direction::Horizontal) ? p.gridRow : p.gridRow + a.charIdx;
-                            int gc = (p.dir == Direction::Horizontal) ? p.gridCol + a.charIdx : p.gridCol;
-                            auto it = m_crosswordSharedCells.find({gr, gc});
-                            if (it != m_crosswordSharedCells.end()) {
-                                for (const auto& owner : it->second) {
-                                    if (owner.first != a.wordIdx) {
-                                        m_checkWordCompletion(owner.first);
-                                    }
+                        if (cell) {
+                            for (int o = 0; o < cell->count; ++o) {
+                                if (cell->owners[o].word != a.wordIdx) {
+                                    m_checkWordCompletion(cell->owners[o].word);
                                 }
                             }
                         }
@@ -802,16 +784,24 @@ void Game::m_loadResources() {
     m_backgroundMusic.setVolume(40.f);
 
     // Load Word List
-    m_fullWordList = Words::loadProcessedWordList("words_processed.csv");
+    m_fullWordList = Words::loadWordList("words_processed.csv", m_wordDetails); // Uses words_processed.wpd when it is up to date
     if (m_fullWordList.empty()) { std::cerr << "Failed to load word list or list is empty. Exiting." << std::endl; exit(1); }
-    m_roots.clear();
-    std::vector<int> potentialBaseLengths = { 4, 5, 6, 7 };
-    for (int len : potentialBaseLengths) {
-        std::vector<WordInfo> wordsOfLength = Words::withLength(m_fullWordList, len);
-        m_roots.insert(m_roots.end(), wordsOfLength.begin(), wordsOfLength.end());
-    }
-    if (m_roots.empty()) { std::cerr << "No suitable root words found in list. Exiting." << std::endl; exit(1); }
-    std::cout << "DEBUG: Populated m_roots with " << m_roots.size() << " potential base words (lengths 4-7)." << std::endl;
+    m_subWordIndex.build(m_fullWordList);
+    m_anagramClassCount = Words::assignAnagramClasses(m_fullWordList); // Before the root pool and puzzles read classes by id
+    m_usedAnagramClassesThisSession.assign(m_anagramClassCount, false);
+    m_rootPool.build(m_fullWordList); // Buckets roots by length/rarity and per-difficulty ideal/fallback
+    if (m_rootPool.empty()) { std::cerr << "No suitable root words found in list. Exiting." << std::endl; exit(1); }
+    m_puzzleGenerator.setVerbose(true); // Keep the step-by-step DEBUG output of m_rebuild
+    CrosswordOptions crosswordOptions;
+    crosswordOptions.timeBudgetMs = CROSSWORD_TIME_BUDGET_MS;
+    crosswordOptions.engine = CrosswordEngine::Greedy; // CrosswordEngine::Beam drops fewer words per trial, ~5-10x slower per trial
+    crosswordOptions.shape = crosswordShape(CrosswordShapePreset::Wide); // Fits the wide grid zone; other presets skip the layout cache
+    if (m_crosswordCache.load(CROSSWORD_CACHE_PATH)) {
+        std::cout << "DEBUG: Loaded " << m_crosswordCache.size() << " crossword layouts from " << CROSSWORD_CACHE_PATH << std::endl;
+    }
+    crosswordOptions.cache = &m_crosswordCache; // Layouts then depend on the cache, not only on the puzzle key
+    m_puzzleGenerator.setCrosswordOptions(crosswordOptions);
+    std::cout << "DEBUG: Populated root pool with " << m_rootPool.size() << " potential base words (lengths " << MIN_ROOT_WORD_LENGTH << "-" << MAX_ROOT_WORD_LENGTH << ")." << std::endl;
 
     // Load Color Themes
     m_themes.clear();
@@ -867,6 +857,7 @@ void Game::m_processEvents()
 // --- Update (Placeholder) ---
 void Game::m_update(sf::Time dt) {
     float deltaSeconds = dt.asSeconds();
+    m_pollCrosswordImprovement();
     m_decor.update(deltaSeconds, m_window.getSize(), m_currentTheme);
 
     // --- Update Score Flourish Timer ---
@@ -924,11 +915,11 @@ void Game::m_update(sf::Time dt) {
 
         // --- Solved Word Hover Detection (grid tiles) ---
         m_hoveredSolvedWordIndex = -1;
-        if (!m_sorted.empty() && !m_grid.empty() && !m_found.empty()) {
+        if (!m_sorted.empty() && !m_grid.empty() && m_puzzleWords.foundGridCount() > 0) {
             const float tileSize = TILE_SIZE * m_currentGridLayoutScale;
             for (std::size_t w = 0; w < m_sorted.size() && w < m_grid.size(); ++w) {
-                if (!m_found.count(m_sorted[w].text)) continue;
-                for (std::size_t c = 0; c < m_sorted[w].text.length() && c < m_grid[w].size(); ++c) {
+                if (!m_puzzleWords.isGridFound(w)) continue;
+                for (std::size_t c = 0; c < m_word(m_sorted[w]).text.length() && c < m_grid[w].size(); ++c) {
                     sf::Vector2f p_tile = m_tilePos(static_cast<int>(w), static_cast<int>(c));
                     sf::FloatRect tileRect({ p_tile.x, p_tile.y }, { tileSize, tileSize });
                     if (tileRect.contains(mappedMousePos)) {
@@ -1020,335 +1011,144 @@ void Game::m_render() {
 
 // --- START OF SIMPLIFIED m_rebuild ---
 
-// --- START OF COMPLETE m_rebuild (Attempt 3 - Verified Fix Location) ---
-void Game::m_rebuild() {
-
-    int maxSolutionsForDifficulty = 0;
-    int minSubLengthForDifficulty = MIN_WORD_LENGTH;
-
-    // Select Random Theme
-    if (!m_themes.empty()) {
-        m_currentTheme = m_themes[0]; //forcing to test colors
-        //m_currentTheme = m_themes[randRange<std::size_t>(0, m_themes.size() - 1)];
-    }
-    else {
-        m_currentTheme = {}; std::cerr << "Warning: No themes loaded, using default colors.\n";
-    }
-
-    // --- Base Word Selection (Collect Candidates, Pick Randomly) ---
-    std::string selectedBaseWord = "";
-    std::string baseWordForGrid = "";
-    bool baseWordFound = false;
-
-    if (m_roots.empty()) {
-        std::cerr << "Error: No root words available for puzzle generation.\n";
-        m_base = "ERROR";
-    }
-    else {
-        PuzzleCriteria baseCriteria = m_getCriteriaForCurrentPuzzle();
-        if (m_gameMode == GameMode::Crossword) {
-            switch (m_selectedDifficulty) {
-            case DifficultyLevel::Easy:   maxSolutionsForDifficulty = CROSSWORD_EASY_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            case DifficultyLevel::Medium: maxSolutionsForDifficulty = CROSSWORD_MEDIUM_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            case DifficultyLevel::Hard:   maxSolutionsForDifficulty = CROSSWORD_HARD_MAX_SOLUTIONS; minSubLengthForDifficulty = HARD_MIN_WORD_LENGTH; break;
-            default: maxSolutionsForDifficulty = 999; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            }
-        } else {
-            switch (m_selectedDifficulty) {
-            case DifficultyLevel::Easy:   maxSolutionsForDifficulty = EASY_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            case DifficultyLevel::Medium: maxSolutionsForDifficulty = MEDIUM_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            case DifficultyLevel::Hard:   maxSolutionsForDifficulty = HARD_MAX_SOLUTIONS; minSubLengthForDifficulty = HARD_MIN_WORD_LENGTH; break;
-            default: maxSolutionsForDifficulty = 999; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
-            }
-        }
-
-        // --- Print Status ---
-        std::cout << "Rebuilding Puzzle " << (m_currentPuzzleIndex + 1) << "/" << m_puzzlesPerSession
-            << " (Difficulty: " << static_cast<int>(m_selectedDifficulty) << ") using pre-calculated metrics." << std::endl;
-        std::cout << "  Base Criteria: Lengths="; for (int l : baseCriteria.allowedLengths) std::cout << l << ","; std::cout << " Rarities="; for (int r : baseCriteria.allowedRarities) std::cout << r << ","; std::cout << std::endl;
-        std::cout << "  Sub Criteria for Final Filter: MinLen=" << minSubLengthForDifficulty << " MaxSol=" << maxSolutionsForDifficulty << std::endl;
-        std::cout << "  DEBUG: Current m_usedBaseWordsThisSession size: " << m_usedBaseWordsThisSession.size() << std::endl;
-        std::cout << "  DEBUG: Current m_usedLetterSetsThisSession size: " << m_usedLetterSetsThisSession.size() << std::endl;
-
-        // --- Shuffle & Prepare Candidate Lists ---
-        std::shuffle(m_roots.begin(), m_roots.end(), Rng());
-        std::vector<int> idealCandidateIndices;     // Indices of words meeting score/count criteria
-        std::vector<int> fallbackCandidateIndices;  // Indices of words meeting basic criteria but not ideal
-        std::vector<int> broadFallbackIndices;    // Indices for broadest fallback if others fail
-
-        std::cout << "DEBUG: Searching for candidate base words..." << std::endl;
-        // --- Loop 1: Find Ideal and Fallback Candidates matching session criteria ---
-        for (std::size_t i = 0; i < m_roots.size(); ++i) {
-            const auto& rootInfo = m_roots[i]; const std::string& candidateWord = rootInfo.text;
-
-            // Check 1: Basic Word Criteria (Length, Rarity)
-            bool lengthMatch = false; for (int len : baseCriteria.allowedLengths) { if (candidateWord.length() == len) { lengthMatch = true; break; } } if (!lengthMatch) continue;
-            bool rarityMatch = false; for (int rarity : baseCriteria.allowedRarities) { if (rootInfo.rarity == rarity) { rarityMatch = true; break; } } if (!rarityMatch) continue;
-
-            // Check 2: Already used this exact word string?
-            if (m_usedBaseWordsThisSession.count(candidateWord)) { continue; }
-
-            // Check 3: Already used this set of letters (anagram)?
-            std::string canonicalCandidate = getCanonicalLetters(candidateWord);
-            if (m_usedLetterSetsThisSession.count(canonicalCandidate)) {
-                // std::cout << "DEBUG: Skipping candidate '" << candidateWord << "' (anagram of used word - canonical: " << canonicalCandidate << ")." << std::endl; // Verbose log
-                continue;
-            }
-
-            // --- If checks passed, classify candidate ---
-            bool isIdeal = false;
-            int validSubCount = 0;
-            switch (m_selectedDifficulty) {
-            case DifficultyLevel::Easy:   validSubCount = rootInfo.easyValidCount; break;
-            case DifficultyLevel::Medium: validSubCount = rootInfo.mediumValidCount; break;
-            case DifficultyLevel::Hard:   validSubCount = rootInfo.hardValidCount; break;
-            default:                      validSubCount = rootInfo.countGE4;
-            }
-            // Check if it meets the "ideal" threshold (good sub-word count)
-            if (validSubCount >= MIN_DESIRED_GRID_WORDS) {
-                idealCandidateIndices.push_back(static_cast<int>(i));
-                isIdeal = true;
-            }
-
-            // If it wasn't ideal but met basic criteria, it's a fallback
-            if (!isIdeal) {
-                fallbackCandidateIndices.push_back(static_cast<int>(i));
-            }
-        } // --- End Loop 1 ---
+// Takes over a generated puzzle: marks its base word used and installs the word lists
+void Game::m_applyPuzzle(Puzzle&& puzzle) {
+    if (puzzle.rootIndex != Words::RootPool::NO_ROOT) {
+        const WordInfo& root = m_rootPool.root(puzzle.rootIndex);
+        if (root.anagramClass < m_usedAnagramClassesThisSession.size()) m_usedAnagramClassesThisSession[root.anagramClass] = true;
+        std::cout << "DEBUG: Added '" << root.text << "' (Anagram class: " << root.anagramClass << ") to used sets." << std::endl;
+    }
+
+    m_base = std::move(puzzle.base);
+    m_allPotentialSolutions = std::move(puzzle.allPotentialSolutions);
+    m_solutions = std::move(puzzle.solutions);
+    m_sorted = std::move(puzzle.sorted);
+    m_crosswordPlacements = std::move(puzzle.crosswordPlacements);
+    m_crosswordGridRows = puzzle.crosswordGridRows;
+    m_crosswordGridCols = puzzle.crosswordGridCols;
+    m_crosswordCells.build(m_crosswordPlacements, m_sorted, m_fullWordList, m_crosswordGridRows, m_crosswordGridCols);
+
+    // Grid words take precedence over a bonus entry with the same text, as in the release check
+    std::vector<std::string> puzzleWords;
+    puzzleWords.reserve(m_sorted.size() + m_allPotentialSolutions.size());
+    for (WordId id : m_sorted) puzzleWords.push_back(m_word(id).text);
+    for (WordId id : m_allPotentialSolutions) puzzleWords.push_back(m_word(id).text);
+    m_puzzleDawg.build(std::move(puzzleWords));
+    m_puzzleWords.build(m_sorted, m_allPotentialSolutions, m_fullWordList);
+    m_guessEntries.assign(m_puzzleDawg.size(), PuzzleWordTable::NO_ENTRY);
+    for (std::size_t w = 0; w < m_sorted.size(); ++w) {
+        std::uint32_t& entry = m_guessEntries[m_puzzleDawg.find(m_word(m_sorted[w]).text)];
+        if (entry == PuzzleWordTable::NO_ENTRY) entry = static_cast<std::uint32_t>(w);
+    }
+    for (WordId id : m_allPotentialSolutions) {
+        const WordInfo& info = m_word(id);
+        std::uint32_t& entry = m_guessEntries[m_puzzleDawg.find(info.text)];
+        if (entry == PuzzleWordTable::NO_ENTRY) entry = m_puzzleWords.find(info.text);
+    }
+
+    // Started by m_pollCrosswordImprovement() once the next puzzle's prefetch is done with the pool
+    if (!puzzle.crosswordInputWords.empty()) m_pendingCrosswordImprovement = std::move(puzzle.crosswordInputWords);
+}
 
-        std::cout << "DEBUG: Found " << idealCandidateIndices.size() << " ideal candidates and "
-            << fallbackCandidateIndices.size() << " fallback candidates meeting session criteria." << std::endl;
 
-        // --- Decide Which Base Word to Use (Pick Randomly from Best Available Pool) ---
-        int chosenIndex = -1;
+PuzzleRequest Game::m_makePuzzleRequest(int puzzleIndex) const {
+    PuzzleRequest request;
+    request.mode = m_gameMode;
+    request.difficulty = m_selectedDifficulty;
+    request.puzzleIndex = puzzleIndex;
+    request.puzzlesPerSession = m_puzzlesPerSession;
+    request.usedAnagramClasses = m_usedAnagramClassesThisSession;
+    const std::uint64_t seedHigh = Rng()(); // Fresh seed per puzzle; the key logged by the generator replays it
+    request.seed = (seedHigh << 32) | Rng()();
+    return request;
+}
 
-        if (!idealCandidateIndices.empty()) {
-            // Pick randomly from ideal candidates
-            std::size_t randomListIndex = randRange<std::size_t>(0, idealCandidateIndices.size() - 1);
-            chosenIndex = idealCandidateIndices[randomListIndex];
-            selectedBaseWord = m_roots[chosenIndex].text;
-            baseWordFound = true;
-            std::cout << "DEBUG: Randomly selected IDEAL candidate #" << randomListIndex << " (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
-        }
-        else if (!fallbackCandidateIndices.empty()) {
-            // No ideal candidates, pick randomly from fallback candidates
-            std::size_t randomListIndex = randRange<std::size_t>(0, fallbackCandidateIndices.size() - 1);
-            chosenIndex = fallbackCandidateIndices[randomListIndex];
-            selectedBaseWord = m_roots[chosenIndex].text;
-            baseWordFound = true;
-            std::cout << "DEBUG: No IDEAL words. Randomly selected FALLBACK candidate #" << randomListIndex << " (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
-        }
-        else {
-            // No candidates met session criteria + unused checks. Apply BROAD fallback search.
-            std::cout << "DEBUG: No candidates met session criteria & unused checks. Applying BROAD fallback search..." << std::endl;
-            // --- Loop 2: Find Broad Fallback Candidates ---
-            for (std::size_t i = 0; i < m_roots.size(); ++i) {
-                const auto& rootInfo = m_roots[i]; const std::string& candidateWord = rootInfo.text;
-                // Just check if used (word or letters)
-                if (m_usedBaseWordsThisSession.count(candidateWord)) continue;
-                std::string canonicalCandidate = getCanonicalLetters(candidateWord);
-                if (m_usedLetterSetsThisSession.count(canonicalCandidate)) continue;
-                // Any unused word/letter set qualifies as broad fallback
-                broadFallbackIndices.push_back(static_cast<int>(i));
-            }
-            std::cout << "DEBUG: Found " << broadFallbackIndices.size() << " broad fallback candidates." << std::endl;
-
-            if (!broadFallbackIndices.empty()) {
-                // Pick randomly from broad fallbacks
-                std::size_t randomListIndex = randRange<std::size_t>(0, broadFallbackIndices.size() - 1);
-                chosenIndex = broadFallbackIndices[randomListIndex];
-                selectedBaseWord = m_roots[chosenIndex].text;
-                baseWordFound = true;
-                std::cout << "DEBUG: Randomly selected BROAD FALLBACK candidate #" << randomListIndex << " (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
-            }
-            else {
-                // Absolute last resort: ALL words/anagrams used
-                std::cerr << "CRITICAL FALLBACK: Cannot find ANY unused root word or letter set. Using first available (may repeat)." << std::endl;
-                if (!m_roots.empty()) {
-                    selectedBaseWord = m_roots[0].text; // Use the very first word
-                    baseWordFound = true;
-                    // Don't add to used sets intentionally here, as it's a forced repeat
-                }
-                else {
-                    selectedBaseWord = "ERROR"; // Should not happen if list loads
-                }
-            }
-        }
 
-        // --- Add chosen word to used sets (unless it was the absolute fallback) ---
-        if (baseWordFound && chosenIndex != -1) { // Check chosenIndex to exclude the absolute fallback case
-            m_usedBaseWordsThisSession.insert(selectedBaseWord);
-            m_usedLetterSetsThisSession.insert(getCanonicalLetters(selectedBaseWord));
-            std::cout << "DEBUG: Added '" << selectedBaseWord << "' (Canonical: " << getCanonicalLetters(selectedBaseWord) << ") to used sets." << std::endl;
-        }
+// Starts preparing the next puzzle of the session on the shared thread pool.
+// Only the immutable word data and the request snapshot are read there.
+void Game::m_startPuzzlePrefetch() {
+    if (!m_isInSession || m_currentPuzzleIndex + 1 >= m_puzzlesPerSession) return;
 
-        m_base = selectedBaseWord; // Assign the final selected word (or "ERROR")
-        baseWordForGrid = selectedBaseWord; // Preserve original base before shuffle
-    } // End if (!m_roots.empty())
+    PuzzleRequest request = m_makePuzzleRequest(m_currentPuzzleIndex + 1); // Rng() itself stays on the main thread
+    m_prefetchedRequest = request;
+    m_prefetchedSerial = m_sessionSerial;
+    m_prefetchedPuzzle = ThreadPool::shared().submit([this, request = std::move(request)]() {
+        return m_puzzleGenerator.generate(request);
+    });
+    std::cout << "DEBUG: Prefetching puzzle " << m_currentPuzzleIndex + 2 << "/" << m_puzzlesPerSession << " in the background." << std::endl;
+}
 
 
-    // Scramble the selected base word letters (only if valid)
-    if (m_base != "ERROR" && !m_base.empty()) {
-        std::shuffle(m_base.begin(), m_base.end(), Rng());
+// Waits for an in-flight prefetch (if any) and drops its result
+void Game::m_cancelPuzzlePrefetch() {
+    if (m_prefetchedPuzzle.valid()) {
+        m_prefetchedPuzzle.wait();
+        m_prefetchedPuzzle = {};
     }
+}
 
 
-    // --- Sub-word Processing (Generate ONCE, Filter Unique, Sort, Truncate) ---
-    std::vector<WordInfo> final_solutions;
-    if (m_base != "ERROR") {
-        m_allPotentialSolutions = Words::subWords(m_base, m_fullWordList);
-        std::cout << "DEBUG: Generating final grid words for selected base letters (current m_base: '" << m_base << "')." << std::endl;
-        std::vector<WordInfo> filtered_sub_solutions; // Initial filtering target
-        std::vector<int> allowedSubRarities;
-        switch (m_selectedDifficulty) { /* ... set allowedSubRarities ... */
-        case DifficultyLevel::Easy:   allowedSubRarities = { 1, 2};    break;
-        case DifficultyLevel::Medium: allowedSubRarities = { 1, 2, 3 }; break;
-        case DifficultyLevel::Hard:   allowedSubRarities = { 2, 3, 4 }; break;
-        default:                      allowedSubRarities = { 1, 2, 3, 4 }; break;
-        }
-
-        for (const auto& subInfo : m_allPotentialSolutions) { /* ... filter by length/rarity into filtered_sub_solutions ... */
-            if (subInfo.text.length() < minSubLengthForDifficulty) continue;
-            bool subRarityMatch = false;
-            for (int subRarity : allowedSubRarities) { if (subInfo.rarity == subRarity) { subRarityMatch = true; break; } }
-            if (!subRarityMatch) continue;
-            filtered_sub_solutions.push_back(subInfo);
-        }
-        std::cout << "DEBUG: Found " << filtered_sub_solutions.size() << " potential grid words matching sub-word difficulty criteria." << std::endl;
-
-        // --- Ensure Uniqueness ---
-        std::cout << "DEBUG: Ensuring uniqueness of potential grid words..." << std::endl;
-        std::set<std::string> unique_texts; std::vector<WordInfo> unique_solutions_temp;
-        unique_solutions_temp.reserve(filtered_sub_solutions.size());
-        for (const auto& info : filtered_sub_solutions) {
-            if (unique_texts.insert(info.text).second) { unique_solutions_temp.push_back(info); }
-        }
-        std::cout << "DEBUG: Reduced to " << unique_solutions_temp.size() << " unique grid words." << std::endl;
-
-        // --- Sort Unique Solutions ---
-        std::cout << "DEBUG: Sorting unique solutions by length/rarity/alpha..." << std::endl;
-        std::sort(unique_solutions_temp.begin(), unique_solutions_temp.end(),
-            [](const WordInfo& a, const WordInfo& b) { /* ... sort logic ... */
-                if (a.text.length() != b.text.length()) return a.text.length() > b.text.length();
-                if (a.rarity != b.rarity) return a.rarity < b.rarity;
-                return a.text < b.text;
-            });
-
-        // --- Truncate Unique Solutions ---
-        if (unique_solutions_temp.size() > maxSolutionsForDifficulty) {
-            std::cout << "DEBUG: Truncating unique sorted solutions from " << unique_solutions_temp.size() << " to " << maxSolutionsForDifficulty << std::endl;
-            unique_solutions_temp.resize(maxSolutionsForDifficulty);
-        }
-        else { std::cout << "DEBUG: No truncation needed for unique grid words." << std::endl; }
-
-        final_solutions = std::move(unique_solutions_temp); // Assign final unique list
-
-        // --- Ensure the base word itself is included in the grid list ---
-        if (!baseWordForGrid.empty()) {
-            std::string baseLower = baseWordForGrid;
-            std::transform(baseLower.begin(), baseLower.end(), baseLower.begin(),
-                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-
-            bool baseAlreadyIncluded = false;
-            for (const auto& info : final_solutions) {
-                if (info.text == baseLower) {
-                    baseAlreadyIncluded = true;
-                    break;
-                }
-            }
-
-            if (!baseAlreadyIncluded) {
-                WordInfo baseInfo;
-                bool foundBaseInfo = false;
-                for (const auto& info : m_roots) {
-                    if (info.text == baseLower) {
-                        baseInfo = info;
-                        foundBaseInfo = true;
-                        break;
-                    }
-                }
-                if (!foundBaseInfo) {
-                    for (const auto& info : m_fullWordList) {
-                        if (info.text == baseLower) {
-                            baseInfo = info;
-                            foundBaseInfo = true;
-                            break;
-                        }
-                    }
-                }
-                if (!foundBaseInfo) {
-                    baseInfo.text = baseLower;
-                    baseInfo.rarity = 0;
-                }
+// Spends spare pool time on more layout trials for this word set, so the cached
+// layout is better the next time the same base word comes up. Skipped while the
+// previous improvement is still running. The search itself stays quiet; its outcome
+// is logged here, on the main thread, when the next one starts.
+void Game::m_startCrosswordImprovement(std::vector<WordId> words) {
+    if (m_crosswordImprovement.valid() && m_crosswordImprovement.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    if (m_crosswordImprovement.valid() && m_crosswordImprovement.get()) {
+        std::cout << "DEBUG: Background crossword search improved a cached layout." << std::endl;
+    }
 
-                if (baseInfo.text.length() >= static_cast<std::size_t>(minSubLengthForDifficulty)) {
-                    final_solutions.push_back(baseInfo);
-                }
-            }
-        }
+    CrosswordOptions options = m_puzzleGenerator.crosswordOptions();
+    options.timeBudgetMs = CROSSWORD_IDLE_BUDGET_MS;
+    options.quiet = true; // Runs on the pool while the main thread logs
+    m_crosswordImprovement = ThreadPool::shared().submit([this, words = std::move(words), options]() {
+        return m_crosswordCache.improve(CrosswordWords(words, m_fullWordList), CROSSWORD_IDLE_TRIALS, options);
+    });
+}
 
-        // --- Fallback: Ensure minimum grid words by promoting bonus words ---
-        const std::size_t minGridTarget = static_cast<std::size_t>(std::min(MIN_DESIRED_GRID_WORDS, maxSolutionsForDifficulty));
-        if (final_solutions.size() < minGridTarget) {
-            std::set<std::string> existingTexts;
-            for (const auto& info : final_solutions) {
-                existingTexts.insert(info.text);
-            }
 
-            std::vector<WordInfo> fallbackCandidates;
-            fallbackCandidates.reserve(m_allPotentialSolutions.size());
-            for (const auto& info : m_allPotentialSolutions) {
-                if (info.text.length() < minSubLengthForDifficulty) {
-                    continue;
-                }
-                if (existingTexts.count(info.text)) {
-                    continue;
-                }
-                fallbackCandidates.push_back(info);
-            }
+// Starts the pending idle improvement once no prefetch is building on the pool, so
+// the next puzzle never waits behind CROSSWORD_IDLE_BUDGET_MS of layout trials.
+void Game::m_pollCrosswordImprovement() {
+    if (m_pendingCrosswordImprovement.empty()) return;
+    if (m_prefetchedPuzzle.valid() && m_prefetchedPuzzle.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    m_startCrosswordImprovement(std::move(m_pendingCrosswordImprovement));
+    m_pendingCrosswordImprovement.clear();
+}
 
-            std::sort(fallbackCandidates.begin(), fallbackCandidates.end(),
-                [](const WordInfo& a, const WordInfo& b) {
-                    if (a.text.length() != b.text.length()) return a.text.length() > b.text.length();
-                    if (a.rarity != b.rarity) return a.rarity < b.rarity;
-                    return a.text < b.text;
-                });
 
-            for (const auto& info : fallbackCandidates) {
-                final_solutions.push_back(info);
-                existingTexts.insert(info.text);
-                if (final_solutions.size() >= minGridTarget) {
-                    break;
-                }
-            }
-        }
+// --- START OF COMPLETE m_rebuild (Attempt 3 - Verified Fix Location) ---
+void Game::m_rebuild() {
 
+    // Select Random Theme
+    if (!m_themes.empty()) {
+        m_currentTheme = m_themes[0]; //forcing to test colors
+        //m_currentTheme = m_themes[randRange<std::size_t>(0, m_themes.size() - 1)];
     }
-    else { // Handle m_base == "ERROR"
-        m_allPotentialSolutions.clear(); final_solutions.clear();
+    else {
+        m_currentTheme = {}; std::cerr << "Warning: No themes loaded, using default colors.\n";
     }
 
-    // Assign final lists for game state
-    m_solutions = final_solutions; // UNIQUE list
-    m_sorted = Words::sortForGrid(m_solutions);
-
-    // --- Crossword mode: arrange words into a crossword layout ---
-    if (m_gameMode == GameMode::Crossword && !m_sorted.empty()) {
-        CrosswordResult cwResult = generateCrossword(m_sorted);
-        m_crosswordPlacements = cwResult.placements;
-        m_crosswordSharedCells = cwResult.sharedCells;
-        m_crosswordGridRows = cwResult.gridRows;
-        m_crosswordGridCols = cwResult.gridCols;
-
-        // Replace sorted/solutions with only the words that were placed
-        m_sorted = cwResult.placedWords;
-        m_solutions = cwResult.placedWords;
-    } else {
-        m_crosswordPlacements.clear();
-        m_crosswordSharedCells.clear();
-        m_crosswordGridRows = 0;
-        m_crosswordGridCols = 0;
+    // --- Puzzle Data (prefetched while the previous puzzle was played, when possible) ---
+    PuzzleRequest request = m_makePuzzleRequest(m_currentPuzzleIndex);
+    Puzzle puzzle;
+    const bool prefetchMatches = m_prefetchedSerial == m_sessionSerial && m_prefetchedRequest.mode == request.mode
+        && m_prefetchedRequest.difficulty == request.difficulty && m_prefetchedRequest.puzzleIndex == request.puzzleIndex
+        && m_prefetchedRequest.puzzlesPerSession == request.puzzlesPerSession;
+    if (m_prefetchedPuzzle.valid() && prefetchMatches) {
+        const bool ready = m_prefetchedPuzzle.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        std::cout << "DEBUG: Using prefetched puzzle " << (m_currentPuzzleIndex + 1) << (ready ? " (ready)." : " (waiting for worker).") << std::endl;
+        puzzle = m_prefetchedPuzzle.get();
+        request.seed = m_prefetchedRequest.seed;
+        request.usedAnagramClasses = m_prefetchedRequest.usedAnagramClasses; // What the worker drew against, for the key
+    }
+    else {
+        m_cancelPuzzlePrefetch(); // Different session/slot, its base-word choice may collide
+        std::cout << "DEBUG: Used anagram classes this session: " << std::count(m_usedAnagramClassesThisSession.begin(), m_usedAnagramClassesThisSession.end(), true) << std::endl;
+        puzzle = m_puzzleGenerator.generate(request);
     }
+    std::cout << "DEBUG: Puzzle key " << puzzleKey(request) << " (replay with PuzzleBatch --replay)." << std::endl;
+    m_applyPuzzle(std::move(puzzle));
 
     m_bonusWordsCacheIsValid = false;
     m_cachedBonusWords.clear();
@@ -1359,12 +1159,12 @@ void Game::m_rebuild() {
     /* ... rest of debug print ... */
     std::cout << "DEBUG: Final list for grid (m_solutions, ALL " << m_solutions.size() << " words):" << std::endl;
     for (size_t i = 0; i < m_solutions.size(); ++i) { // Loop up to the actual size of m_solutions
-        std::cout << "  - '" << m_solutions[i].text
-            << "' (Len=" << m_solutions[i].text.length()
-            << ", Rarity=" << m_solutions[i].rarity << ")" << std::endl;
+        std::cout << "  - '" << m_word(m_solutions[i]).text
+            << "' (Len=" << m_word(m_solutions[i]).text.length()
+            << ", Rarity=" << m_word(m_solutions[i]).rarity << ")" << std::endl;
     }
     if (!m_sorted.empty()) {
-        std::cout << "DEBUG: m_rebuild - First sorted word for grid display: '" << m_sorted[0].text << "'" << std::endl;
+        std::cout << "DEBUG: m_rebuild - First sorted word for grid display: '" << m_word(m_sorted[0]).text << "'" << std::endl;
     }
     else { std::cout << "DEBUG: m_rebuild - No words selected for the grid." << std::endl; }
 
@@ -1372,17 +1172,10 @@ void Game::m_rebuild() {
     std::cout << "DEBUG: Potential Bonus Words (" << m_allPotentialSolutions.size() - m_solutions.size() << " expected):" << std::endl;
     int actualBonusCount = 0;
     if (!m_allPotentialSolutions.empty()) {
-        for (const auto& potentialSolutionInfo : m_allPotentialSolutions) {
+        for (WordId potentialId : m_allPotentialSolutions) {
+            const WordInfo& potentialSolutionInfo = m_word(potentialId);
             // Check if this potential solution is NOT in the main m_solutions list
-            bool isGridWord = false;
-            for (const auto& gridSolutionInfo : m_solutions) {
-                if (potentialSolutionInfo.text == gridSolutionInfo.text) {
-                    isGridWord = true;
-                    break;
-                }
-            }
-
-            if (!isGridWord) {
+            if (!isGridSolution(potentialSolutionInfo.text)) {
                 // It's a bonus word
                 std::cout << "  - BONUS: '" << potentialSolutionInfo.text
                     << "' (Len=" << potentialSolutionInfo.text.length()
@@ -1403,12 +1196,12 @@ void Game::m_rebuild() {
     // --- Setup Grid & Reset State ---
     m_grid.assign(m_sorted.size(), {});
     for (std::size_t i = 0; i < m_sorted.size(); ++i) { /* ... assign grid blanks ... */
-        if (!m_sorted[i].text.empty()) {
-            m_grid[i].assign(m_sorted[i].text.length(), '_');
+        if (!m_word(m_sorted[i]).text.empty()) {
+            m_grid[i].assign(m_word(m_sorted[i]).text.length(), '_');
         }
         else { m_grid[i].clear(); std::cerr << "Warning: Word at m_sorted index " << i << " has empty text. Grid row will be empty." << std::endl; }
     }
-    m_found.clear(); m_foundBonusWords.clear(); m_anims.clear(); m_scoreAnims.clear(); m_hintPointAnims.clear(); m_scoreFlourishes.clear();
+    m_puzzleWords.clearFound(); m_anims.clear(); m_scoreAnims.clear(); m_hintPointAnims.clear(); m_scoreFlourishes.clear();
     m_hintPointsTextFlourishTimer = 0.f;
     m_clearDragState();
     m_clearPendingLetterHintTarget();
@@ -1446,6 +1239,8 @@ void Game::m_rebuild() {
         }
     }
 
+    m_startPuzzlePrefetch(); // Next puzzle is built while this one is played
+
 } // End Game::m_rebuild
 
 
@@ -1630,7 +1425,7 @@ void Game::m_updateLayout(sf::Vector2u windowSize) {
         for (int tryCols = 1; tryCols <= maxPossibleCols; ++tryCols) {
             int rowsNeeded = (static_cast<int>(m_sorted.size()) + tryCols - 1) / tryCols; if (rowsNeeded <= 0) rowsNeeded = 1;
             std::vector<int> currentTryColMaxLen(tryCols, 0); float currentTryWidthUnscaled = 0;
-            for (size_t w = 0; w < m_sorted.size(); ++w) { int c = static_cast<int>(w) / rowsNeeded; if (c >= 0 && c < tryCols) { currentTryColMaxLen[c] = std::max<int>(currentTryColMaxLen[c], static_cast<int>(m_sorted[w].text.length())); } }
+            for (size_t w = 0; w < m_sorted.size(); ++w) { int c = static_cast<int>(w) / rowsNeeded; if (c >= 0 && c < tryCols) { currentTryColMaxLen[c] = std::max<int>(currentTryColMaxLen[c], static_cast<int>(m_word(m_sorted[w]).text.length())); } }
             for (int len : currentTryColMaxLen) { currentTryWidthUnscaled += static_cast<float>(len) * stpw_base_design - (len > 0 ? sp_base_design : 0.f); }
             currentTryWidthUnscaled += static_cast<float>(std::max(0, tryCols - 1)) * sc_base_design; if (currentTryWidthUnscaled < 0) currentTryWidthUnscaled = 0;
             if (currentTryWidthUnscaled < minWidthOverall) { minWidthOverall = currentTryWidthUnscaled; narrowestOverallCols = tryCols; narrowestOverallRows = rowsNeeded; }
@@ -1649,7 +1444,7 @@ void Game::m_updateLayout(sf::Vector2u windowSize) {
         m_colMaxLen.assign(numCols, 0);
         for (size_t w = 0; w < m_sorted.size(); ++w) {
             int c = static_cast<int>(w) / maxRowsPerCol; if (c >= numCols) c = numCols - 1;
-            if (c >= 0 && static_cast<size_t>(c) < m_colMaxLen.size()) { m_colMaxLen[c] = std::max<int>(m_colMaxLen[c], static_cast<int>(m_sorted[w].text.length())); }
+            if (c >= 0 && static_cast<size_t>(c) < m_colMaxLen.size()) { m_colMaxLen[c] = std::max<int>(m_colMaxLen[c], static_cast<int>(m_word(m_sorted[w]).text.length())); }
         }
 
         float totalRequiredWidthUnscaled = 0;
@@ -2175,6 +1970,35 @@ void Game::m_clearDragState() {
     m_dragging = false;
     m_path.clear();
     m_currentGuess.clear();
+    m_guessSteps.clear();
+}
+
+// Extends the drag path with wheel letter 'baseIndex', one m_puzzleDawg step per letter
+void Game::m_pushGuessLetter(int baseIndex) {
+    const char letter = m_base[baseIndex];
+    const Words::WordDawg::Cursor from = m_guessSteps.empty() ? m_puzzleDawg.root() : m_guessSteps.back();
+    m_path.push_back(baseIndex);
+    m_currentGuess += static_cast<char>(std::toupper(letter));
+    m_guessSteps.push_back(m_puzzleDawg.step(from, letter));
+}
+
+// Backtracks one letter; the previous cursor is still on the stack
+void Game::m_popGuessLetter() {
+    if (!m_path.empty()) m_path.pop_back();
+    if (!m_currentGuess.empty()) m_currentGuess.pop_back();
+    if (!m_guessSteps.empty()) m_guessSteps.pop_back();
+}
+
+// m_puzzleWords entry the current guess spells, NO_ENTRY when it is no puzzle word
+std::uint32_t Game::m_currentGuessEntry() const {
+    if (m_guessSteps.empty()) return PuzzleWordTable::NO_ENTRY;
+    const std::uint32_t ordinal = m_puzzleDawg.ordinal(m_guessSteps.back());
+    return (ordinal != Words::WordDawg::NO_WORD) ? m_guessEntries[ordinal] : PuzzleWordTable::NO_ENTRY;
+}
+
+// Whether the first 'letters' letters of the guess still start some puzzle word
+bool Game::m_guessPrefixAlive(std::size_t letters) const {
+    return letters == 0 || (letters <= m_guessSteps.size() && m_guessSteps[letters - 1].alive());
 }
 
 void Game::m_clearPendingLetterHintTarget() {
@@ -2191,7 +2015,7 @@ bool Game::m_isValidLetterHintTargetTile(int wordIdx, int charIdx) const {
     if (static_cast<std::size_t>(charIdx) >= m_grid[wordIdx].size()) {
         return false;
     }
-    if (m_found.count(m_sorted[wordIdx].text)) {
+    if (m_puzzleWords.isGridFound(wordIdx)) {
         return false;
     }
     return m_grid[wordIdx][charIdx] == '_';
@@ -2202,7 +2026,7 @@ bool Game::m_revealSpecificGridLetter(int wordIdx, int charIdx) {
         return false;
     }
 
-    const std::string& solutionWord = m_sorted[wordIdx].text;
+    const std::string& solutionWord = m_word(m_sorted[wordIdx]).text;
     if (static_cast<std::size_t>(charIdx) >= solutionWord.length()) {
         std::cerr << "ERROR: Letter hint target index out of bounds for solution word." << std::endl;
         return false;
@@ -2303,7 +2127,8 @@ void Game::m_handleCasualMenuEvents(const sf::Event& event) {
             m_puzzlesPerSession = puzzles;
             m_currentPuzzleIndex = 0; // Start at the first puzzle (index 0)
             m_isInSession = true;
-            m_usedBaseWordsThisSession.clear();
+            m_usedAnagramClassesThisSession.assign(m_anagramClassCount, false);
+            m_sessionSerial++;
             // ------------------------
 
             m_rebuild(); // Rebuild game for the FIRST puzzle of the session
@@ -2312,43 +2137,6 @@ void Game::m_handleCasualMenuEvents(const sf::Event& event) {
     }
 }
 
-// In Game.cpp (add this new function definition)
-
-Game::PuzzleCriteria Game::m_getCriteriaForCurrentPuzzle() const {
-    PuzzleCriteria criteria;
-    bool isLastPuzzle = (m_currentPuzzleIndex == m_puzzlesPerSession - 1);
-
-    switch (m_selectedDifficulty) {
-    case DifficultyLevel::Easy:
-        criteria.allowedRarities = { 1 }; // Primarily Rarity 1
-        criteria.allowedLengths = { 7 }; // Force 7-letter puzzles
-        break;
-
-    case DifficultyLevel::Medium:
-        criteria.allowedRarities = { 1, 2, 3 }; // Rarity 1, 2, or 3
-        criteria.allowedLengths = { 7 }; // Force 7-letter puzzles
-        break;
-
-    case DifficultyLevel::Hard:
-        criteria.allowedLengths = { 7 };   // Force 7-letter puzzles
-        if (isLastPuzzle) {
-            criteria.allowedRarities = { 4 };  // Last puzzle is Rarity 4
-        }
-        else {
-            criteria.allowedRarities = { 3, 4 };   // Rarity 3 or 4
-        }
-        break;
-
-    case DifficultyLevel::None: // Fallback or other modes
-    default:
-        // Default criteria (e.g., allow a wide range if not in a session)
-        criteria.allowedLengths = { 4, 5, 6, 7 }; // Or use WORD_LENGTH constant range
-        criteria.allowedRarities = { 1, 2, 3, 4 }; // All rarities
-        break;
-    }
-    return criteria;
-}
-
 void Game::m_renderMainMenu(const sf::Vector2f& mousePos) {
     // Apply theme colors (fallback when menu background texture not used)
     m_mainMenuBg.setFillColor(m_currentTheme.menuBg);
@@ -2444,7 +2232,8 @@ void Game::m_handleCrosswordMenuEvents(const sf::Event& event) {
             m_puzzlesPerSession = puzzles;
             m_currentPuzzleIndex = 0;
             m_isInSession = true;
-            m_usedBaseWordsThisSession.clear();
+            m_usedAnagramClassesThisSession.assign(m_anagramClassCount, false);
+            m_sessionSerial++;
 
             m_rebuild();
             m_currentScreen = GameScreen::Playing;
@@ -2596,7 +2385,7 @@ void Game::m_handlePlayingEvents(const sf::Event& event) {
                     if (i == 0) {
                         bool hasValidTarget = false;
                         for (std::size_t w = 0; w < m_sorted.size() && w < m_grid.size() && !hasValidTarget; ++w) {
-                            if (m_found.count(m_sorted[w].text)) {
+                            if (m_puzzleWords.isGridFound(w)) {
                                 continue;
                             }
                             for (std::size_t c = 0; c < m_grid[w].size(); ++c) {
@@ -2638,10 +2427,9 @@ void Game::m_handlePlayingEvents(const sf::Event& event) {
             // Letter Wheel Click (from original)
             for (std::size_t i = 0; i < m_base.size(); ++i) {
                 if (i < m_wheelLetterRenderPos.size() && distSq(mp, m_wheelLetterRenderPos[i]) < m_currentLetterRenderRadius * m_currentLetterRenderRadius) {
+                    m_clearDragState();
                     m_dragging = true;
-                    m_path.clear();
-                    m_path.push_back(static_cast<int>(i));
-                    m_currentGuess += static_cast<char>(std::toupper(m_base[i]));
+                    m_pushGuessLetter(static_cast<int>(i));
                     if (m_selectSound) m_selectSound->play();
                 }
             }
@@ -2678,8 +2466,7 @@ void Game::m_handlePlayingEvents(const sf::Event& event) {
 
                     if (!alreadyInPath) {
                         // --- Add new letter to path ---
-                        m_path.push_back(letterIndexInMPath);
-                        m_currentGuess += static_cast<char>(std::toupper(m_base[i])); // Use m_base[i]
+                        m_pushGuessLetter(letterIndexInMPath); // Also advances the dictionary cursor
                         if (m_selectSound) m_selectSound->play();
                         // No need for actionTaken if we allow multiple letters to be evaluated per mouse move,
                         // though usually, you only want to act on the *first one* you enter.
@@ -2693,10 +2480,7 @@ void Game::m_handlePlayingEvents(const sf::Event& event) {
                         //            we are hovering over the second-to-last letter ADDED to m_path
                         if (m_path.size() >= 2 && m_path[m_path.size() - 2] == letterIndexInMPath) {
                             // Remove the *last* element from path and guess
-                            m_path.pop_back();
-                            if (!m_currentGuess.empty()) {
-                                m_currentGuess.pop_back();
-                            }
+                            m_popGuessLetter();
                             // Optional: Play an "unselect" sound
                             // actionTaken = true; break; // If only one action per move event
                         }
@@ -2733,176 +2517,170 @@ void Game::m_handlePlayingEvents(const sf::Event& event) {
 
             std::cout << "DEBUG: Mouse Released. Processing Guess (Length >= " << MIN_GUESS_LENGTH << "): '" << m_currentGuess << "'" << std::endl;
 
+            // The cursors were walked while the guess was built; only the table lookup is left
+            const std::uint32_t guessEntry = m_currentGuessEntry();
+            const PuzzleWordTable::Entry* guessWord = (guessEntry != PuzzleWordTable::NO_ENTRY) ? &m_puzzleWords.entry(guessEntry) : nullptr;
+
             // --- Phase 1: Check against GRID words ---
-            for (std::size_t w = 0; w < m_sorted.size(); ++w) {
-                const std::string& solutionOriginalCase = m_sorted[w].text;
-                std::string solutionUpper = solutionOriginalCase;
-                std::transform(solutionUpper.begin(), solutionUpper.end(), solutionUpper.begin(), ::toupper);
-
-                if (solutionUpper == m_currentGuess) {
-                    wordMatched = solutionOriginalCase; // Store the matched word (original case)
-                    wordIndexMatched = static_cast<int>(w); // Store its index
-
-                    if (m_found.count(solutionOriginalCase)) {
-                        // --- Repeated GRID Word ---
-                        std::cout << "DEBUG: Matched GRID word '" << solutionOriginalCase << "', but already found." << std::endl;
-                        // Trigger flourish for existing grid letters
-                        for (int c = 0; c < solutionOriginalCase.length(); ++c) {
-                            m_gridFlourishes.push_back({ wordIndexMatched, c, GRID_FLOURISH_DURATION });
-                        }
-                        if (m_placeSound) m_placeSound->play(); // Use error/repeat sound
-                        actionTaken = true;
+            if (guessWord && guessWord->kind == PuzzleWordTable::Kind::Grid) {
+                const std::size_t w = guessWord->index;
+                const std::string& solutionOriginalCase = m_word(m_sorted[w]).text;
+                wordMatched = solutionOriginalCase; // Store the matched word (original case)
+                wordIndexMatched = static_cast<int>(w); // Store its index
+
+                if (m_puzzleWords.isFound(guessEntry)) {
+                    // --- Repeated GRID Word ---
+                    std::cout << "DEBUG: Matched GRID word '" << solutionOriginalCase << "', but already found." << std::endl;
+                    // Trigger flourish for existing grid letters
+                    for (int c = 0; c < solutionOriginalCase.length(); ++c) {
+                        m_gridFlourishes.push_back({ wordIndexMatched, c, GRID_FLOURISH_DURATION });
                     }
-                    else {
-                        // --- NEW Grid Word Found ---
-                        std::cout << "DEBUG: Found NEW match on GRID: '" << solutionOriginalCase << "'" << std::endl;
-                        m_found.insert(solutionOriginalCase);
-
-                        int baseScore = static_cast<int>(m_currentGuess.length()) * 10;
-                        int rarityBonus = (m_sorted[w].rarity > 1) ? (m_sorted[w].rarity * 25) : 0;
-                        int wordScoreForThisWord = baseScore + rarityBonus;
-
-                        m_currentScore += wordScoreForThisWord;
-                        m_spawnScoreFlourish(wordScoreForThisWord, static_cast<int>(w));
-
-                        if (m_scoreValueText) m_scoreValueText->setString(std::to_string(m_currentScore));
-
-                        // m_wordsSolvedSinceHint++; // This was for gaining free hints, hints are now bought with points.
-                        // if (m_wordsSolvedSinceHint >= WORDS_PER_HINT) {
-                        //     m_hintsAvailable++; m_wordsSolvedSinceHint = 0;
-                        //     if (m_hintCountTxt) m_hintCountTxt->setString("Hints: " + std::to_string(m_hintsAvailable));
-                        // }
-
-                        for (std::size_t c = 0; c < m_currentGuess.length(); ++c) {
-                            if (c < m_path.size()) {
-                                int pathNodeIdx = m_path[c];
-                                if (pathNodeIdx >= 0 && static_cast<size_t>(pathNodeIdx) < m_wheelLetterRenderPos.size() &&
-                                    static_cast<size_t>(pathNodeIdx) < m_base.size()) {
-
-                                    sf::Vector2f startPos = m_wheelLetterRenderPos[pathNodeIdx];
-                                    sf::Vector2f endPos = m_tilePos(wordIndexMatched, static_cast<int>(c));
-
-                                    float finalRenderTileSize = TILE_SIZE * m_currentGridLayoutScale;
-                                    endPos.x += finalRenderTileSize / 2.f;
-                                    endPos.y += finalRenderTileSize / 2.f;
-
-                                    m_anims.push_back({
-                                        m_currentGuess[c],
-                                        startPos,
-                                        endPos,
-                                        0.f - (c * 0.03f),
-                                        wordIndexMatched,
-                                        static_cast<int>(c),
-                                        AnimTarget::Grid
-                                        });
-                                }
+                    if (m_placeSound) m_placeSound->play(); // Use error/repeat sound
+                    actionTaken = true;
+                }
+                else {
+                    // --- NEW Grid Word Found ---
+                    std::cout << "DEBUG: Found NEW match on GRID: '" << solutionOriginalCase << "'" << std::endl;
+                    m_puzzleWords.markFound(guessEntry);
+
+                    int baseScore = static_cast<int>(m_currentGuess.length()) * 10;
+                    int rarityBonus = (m_word(m_sorted[w]).rarity > 1) ? (m_word(m_sorted[w]).rarity * 25) : 0;
+                    int wordScoreForThisWord = baseScore + rarityBonus;
+
+                    m_currentScore += wordScoreForThisWord;
+                    m_spawnScoreFlourish(wordScoreForThisWord, static_cast<int>(w));
+
+                    if (m_scoreValueText) m_scoreValueText->setString(std::to_string(m_currentScore));
+
+                    // m_wordsSolvedSinceHint++; // This was for gaining free hints, hints are now bought with points.
+                    // if (m_wordsSolvedSinceHint >= WORDS_PER_HINT) {
+                    //     m_hintsAvailable++; m_wordsSolvedSinceHint = 0;
+                    //     if (m_hintCountTxt) m_hintCountTxt->setString("Hints: " + std::to_string(m_hintsAvailable));
+                    // }
+
+                    for (std::size_t c = 0; c < m_currentGuess.length(); ++c) {
+                        if (c < m_path.size()) {
+                            int pathNodeIdx = m_path[c];
+                            if (pathNodeIdx >= 0 && static_cast<size_t>(pathNodeIdx) < m_wheelLetterRenderPos.size() &&
+                                static_cast<size_t>(pathNodeIdx) < m_base.size()) {
+
+                                sf::Vector2f startPos = m_wheelLetterRenderPos[pathNodeIdx];
+                                sf::Vector2f endPos = m_tilePos(wordIndexMatched, static_cast<int>(c));
+
+                                float finalRenderTileSize = TILE_SIZE * m_currentGridLayoutScale;
+                                endPos.x += finalRenderTileSize / 2.f;
+                                endPos.y += finalRenderTileSize / 2.f;
+
+                                m_anims.push_back({
+                                    m_currentGuess[c],
+                                    startPos,
+                                    endPos,
+                                    0.f - (c * 0.03f),
+                                    wordIndexMatched,
+                                    static_cast<int>(c),
+                                    AnimTarget::Grid
+                                    });
                             }
                         }
-                        std::cout << "GRID Word: " << m_currentGuess << " | Rarity: " << m_sorted[wordIndexMatched].rarity << " | Len: " << m_currentGuess.length() << " | Rarity Bonus: " << rarityBonus << " | BasePts: " << baseScore << " | Current Game Score: " << m_currentScore << std::endl;
-
-                        if (m_found.size() == m_solutions.size()) {
-                            std::cout << "DEBUG: All grid words found! Puzzle solved." << std::endl;
-                            if (m_winSound) m_winSound->play();
-                            m_gameState = GState::Solved;
-                            m_currentScreen = GameScreen::GameOver;
-                            m_updateLayout(m_window.getSize());
-                        }
-                        actionTaken = true;
                     }
-                    goto process_outcome;
+                    std::cout << "GRID Word: " << m_currentGuess << " | Rarity: " << m_word(m_sorted[wordIndexMatched]).rarity << " | Len: " << m_currentGuess.length() << " | Rarity Bonus: " << rarityBonus << " | BasePts: " << baseScore << " | Current Game Score: " << m_currentScore << std::endl;
+
+                    if (m_puzzleWords.allGridFound()) {
+                        std::cout << "DEBUG: All grid words found! Puzzle solved." << std::endl;
+                        if (m_winSound) m_winSound->play();
+                        m_gameState = GState::Solved;
+                        m_currentScreen = GameScreen::GameOver;
+                        m_updateLayout(m_window.getSize());
+                    }
+                    actionTaken = true;
                 }
-            } // --- End Grid Check Loop ---
+                goto process_outcome;
+            } // --- End Grid Check ---
 
 
             // --- Phase 2: Check against BONUS words (only if no grid match occurred) ---
             std::cout << "DEBUG: Checking for BONUS word..." << std::endl;
-            for (const auto& potentialWordInfo : m_allPotentialSolutions) {
-                const std::string& bonusWordOriginalCase = potentialWordInfo.text;
-                if (m_found.count(bonusWordOriginalCase)) { continue; }
-
-                std::string bonusWordUpper = bonusWordOriginalCase;
-                std::transform(bonusWordUpper.begin(), bonusWordUpper.end(), bonusWordUpper.begin(), ::toupper);
-
-                if (bonusWordUpper == m_currentGuess) {
-                    wordMatched = bonusWordOriginalCase;
-
-                    if (m_foundBonusWords.count(bonusWordOriginalCase)) {
-                        // --- Repeated BONUS Word ---
-                        std::cout << "DEBUG: Matched BONUS word '" << bonusWordOriginalCase << "', but already found AS BONUS." << std::endl;
-                        m_bonusTextFlourishTimer = BONUS_TEXT_FLOURISH_DURATION;
-                        if (m_placeSound) m_placeSound->play();
-                        actionTaken = true;
+            if (guessWord && guessWord->kind == PuzzleWordTable::Kind::Bonus) {
+                const std::string& bonusWordOriginalCase = m_word(m_allPotentialSolutions[guessWord->index]).text;
+                wordMatched = bonusWordOriginalCase;
+
+                if (m_puzzleWords.isFound(guessEntry)) {
+                    // --- Repeated BONUS Word ---
+                    std::cout << "DEBUG: Matched BONUS word '" << bonusWordOriginalCase << "', but already found AS BONUS." << std::endl;
+                    m_bonusTextFlourishTimer = BONUS_TEXT_FLOURISH_DURATION;
+                    if (m_placeSound) m_placeSound->play();
+                    actionTaken = true;
+                }
+                else {
+                    // --- NEW Bonus Word Found ---
+                    std::cout << "DEBUG: Found NEW match for BONUS: '" << bonusWordOriginalCase << "'" << std::endl;
+                    m_puzzleWords.markFound(guessEntry);
+
+                    int hintPointsAwarded = 0;
+                    size_t len = bonusWordOriginalCase.length();
+                    if (len == 3) hintPointsAwarded = 1;
+                    else if (len == 4) hintPointsAwarded = 2;
+                    else if (len == 5) hintPointsAwarded = 3;
+                    else if (len == 6) hintPointsAwarded = 4;
+                    else if (len == 7) hintPointsAwarded = 5;
+
+                    if (hintPointsAwarded > 0) {
+                        m_hintPoints += hintPointsAwarded;
+                        std::cout << "DEBUG: Hint Points increased by " << hintPointsAwarded << ". New Total Hint Points: " << m_hintPoints << std::endl;
+                        if (m_hintPointsText) m_hintPointsText->setString("Points: " + std::to_string(m_hintPoints));
+
+                        float bonusTextApproxY = m_wheelY + (m_currentWheelRadius + S(this, 30.f))
+                            + S(this, HUD_TEXT_OFFSET_Y) + S(this, 20.f) + S(this, HUD_LINE_SPACING) + S(this, 10.f);
+                        sf::FloatRect bonusSummaryBounds = m_bonusWordsInHintZoneText->getGlobalBounds();
+                        sf::Vector2f hintAnimStartPos = { bonusSummaryBounds.position.x + bonusSummaryBounds.size.x / 2.f,
+                                                          bonusSummaryBounds.position.y + bonusSummaryBounds.size.y / 2.f };
+                        m_spawnHintPointAnimation(hintAnimStartPos, hintPointsAwarded);
                     }
-                    else {
-                        // --- NEW Bonus Word Found ---
-                        std::cout << "DEBUG: Found NEW match for BONUS: '" << bonusWordOriginalCase << "'" << std::endl;
-                        m_foundBonusWords.insert(bonusWordOriginalCase);
-
-                        int hintPointsAwarded = 0;
-                        size_t len = bonusWordOriginalCase.length();
-                        if (len == 3) hintPointsAwarded = 1;
-                        else if (len == 4) hintPointsAwarded = 2;
-                        else if (len == 5) hintPointsAwarded = 3;
-                        else if (len == 6) hintPointsAwarded = 4;
-                        else if (len == 7) hintPointsAwarded = 5;
-
-                        if (hintPointsAwarded > 0) {
-                            m_hintPoints += hintPointsAwarded;
-                            std::cout << "DEBUG: Hint Points increased by " << hintPointsAwarded << ". New Total Hint Points: " << m_hintPoints << std::endl;
-                            if (m_hintPointsText) m_hintPointsText->setString("Points: " + std::to_string(m_hintPoints));
-
-                            float bonusTextApproxY = m_wheelY + (m_currentWheelRadius + S(this, 30.f))
-                                + S(this, HUD_TEXT_OFFSET_Y) + S(this, 20.f) + S(this, HUD_LINE_SPACING) + S(this, 10.f);
-                            sf::FloatRect bonusSummaryBounds = m_bonusWordsInHintZoneText->getGlobalBounds();
-                            sf::Vector2f hintAnimStartPos = { bonusSummaryBounds.position.x + bonusSummaryBounds.size.x / 2.f,
-                                                              bonusSummaryBounds.position.y + bonusSummaryBounds.size.y / 2.f };
-                            m_spawnHintPointAnimation(hintAnimStartPos, hintPointsAwarded);
-                        }
 
-                        std::cout << "BONUS Word: " << m_currentGuess << " (Length: " << len << ") | Hint Points Awarded: " << hintPointsAwarded << std::endl;
+                    std::cout << "BONUS Word: " << m_currentGuess << " (Length: " << len << ") | Hint Points Awarded: " << hintPointsAwarded << std::endl;
 
-                        //m_bonusTextFlourishTimer = BONUS_TEXT_FLOURISH_DURATION;
-                        if (m_placeSound) m_placeSound->play();
-                        actionTaken = true;
-
-                        // ***** NEW: Check for Full Bonus List Completion *****
-                        int totalPossibleBonus = m_calculateTotalPossibleBonusWords();
-                        if (totalPossibleBonus > 0 && m_foundBonusWords.size() == static_cast<size_t>(totalPossibleBonus)) {
-                            std::cout << "DEBUG: *** ENTIRE BONUS LIST COMPLETED! ***" << std::endl;
-
-                            // Calculate points for bonus list completion
-                            int rawCompletionValue = 0;
-                            // Pn_complete values (points per word length for this specific bonus)
-                            const int p3c = 5, p4c = 10, p5c = 20, p6c = 35, p7c = 50;
-                            // Iterate through m_cachedBonusWords (which should be populated by now)
-                            // Or, more robustly, iterate m_allPotentialSolutions and check if non-grid
-                            for (const auto& bWordInfo : m_allPotentialSolutions) {
-                                if (!isGridSolution(bWordInfo.text)) { // It's a bonus word
-                                    size_t bLen = bWordInfo.text.length();
-                                    if (bLen == 3) rawCompletionValue += p3c;
-                                    else if (bLen == 4) rawCompletionValue += p4c;
-                                    else if (bLen == 5) rawCompletionValue += p5c;
-                                    else if (bLen == 6) rawCompletionValue += p6c;
-                                    else if (bLen == 7) rawCompletionValue += p7c;
-                                }
+                    //m_bonusTextFlourishTimer = BONUS_TEXT_FLOURISH_DURATION;
+                    if (m_placeSound) m_placeSound->play();
+                    actionTaken = true;
+
+                    // ***** NEW: Check for Full Bonus List Completion *****
+                    int totalPossibleBonus = m_calculateTotalPossibleBonusWords();
+                    if (totalPossibleBonus > 0 && m_puzzleWords.foundBonusCount() == static_cast<size_t>(totalPossibleBonus)) {
+                        std::cout << "DEBUG: *** ENTIRE BONUS LIST COMPLETED! ***" << std::endl;
+
+                        // Calculate points for bonus list completion
+                        int rawCompletionValue = 0;
+                        // Pn_complete values (points per word length for this specific bonus)
+                        const int p3c = 5, p4c = 10, p5c = 20, p6c = 35, p7c = 50;
+                        // Iterate through m_cachedBonusWords (which should be populated by now)
+                        // Or, more robustly, iterate m_allPotentialSolutions and check if non-grid
+                        for (WordId bWordId : m_allPotentialSolutions) {
+                            const WordInfo& bWordInfo = m_word(bWordId);
+                            if (!isGridSolution(bWordInfo.text)) { // It's a bonus word
+                                size_t bLen = bWordInfo.text.length();
+                                if (bLen == 3) rawCompletionValue += p3c;
+                                else if (bLen == 4) rawCompletionValue += p4c;
+                                else if (bLen == 5) rawCompletionValue += p5c;
+                                else if (bLen == 6) rawCompletionValue += p6c;
+                                else if (bLen == 7) rawCompletionValue += p7c;
                             }
+                        }
 
-                            int flatFullClearBonus = 150; // Example
-                            float difficultyMultiplier = 1.0f;
-                            if (m_selectedDifficulty == DifficultyLevel::Medium) difficultyMultiplier = 1.25f;
-                            else if (m_selectedDifficulty == DifficultyLevel::Hard) difficultyMultiplier = 1.5f;
+                        int flatFullClearBonus = 150; // Example
+                        float difficultyMultiplier = 1.0f;
+                        if (m_selectedDifficulty == DifficultyLevel::Medium) difficultyMultiplier = 1.25f;
+                        else if (m_selectedDifficulty == DifficultyLevel::Hard) difficultyMultiplier = 1.5f;
 
-                            int finalBonusListScore = static_cast<int>((static_cast<float>(rawCompletionValue) + static_cast<float>(flatFullClearBonus)) * difficultyMultiplier);
+                        int finalBonusListScore = static_cast<int>((static_cast<float>(rawCompletionValue) + static_cast<float>(flatFullClearBonus)) * difficultyMultiplier);
 
-                            m_triggerBonusListCompleteEffect(finalBonusListScore);
-                            // Note: The points are added to m_currentScore inside m_updateBonusListCompleteEffect 
-                            // when the animation timer finishes, to sync with the visual effect.
-                        }
-                        // ***** END NEW CHECK *****
+                        m_triggerBonusListCompleteEffect(finalBonusListScore);
+                        // Note: The points are added to m_currentScore inside m_updateBonusListCompleteEffect 
+                        // when the animation timer finishes, to sync with the visual effect.
                     }
-                    goto process_outcome;
+                    // ***** END NEW CHECK *****
                 }
-            } // --- End Bonus Check Loop ---
+                goto process_outcome;
+            } // --- End Bonus Check ---
 
 
             // --- Phase 3: Incorrect Word ---
@@ -2969,7 +2747,7 @@ void Game::m_handleGameOverEvents(const sf::Event& event) {
                         // --- Go to Next Puzzle ---
                         std::cout << "DEBUG: Continuing Session - Calling m_rebuild for puzzle " << m_currentPuzzleIndex + 1 << std::endl;
                         std::cout << "DEBUG: BEFORE rebuilding puzzle " << m_currentPuzzleIndex + 1
-                            << ", m_usedBaseWordsThisSession size = " << m_usedBaseWordsThisSession.size() << std::endl;
+                            << ", used anagram classes = " << std::count(m_usedAnagramClassesThisSession.begin(), m_usedAnagramClassesThisSession.end(), true) << std::endl;
                         m_rebuild();
                         m_currentScreen = GameScreen::Playing;
                         m_gameState = GState::Playing;
@@ -3086,8 +2864,8 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
 
         for (std::size_t w = 0; w < m_sorted.size(); ++w) {
             if (w >= m_grid.size()) continue;
-            int wordRarity = m_sorted[w].rarity;
-            for (std::size_t c = 0; c < m_sorted[w].text.length(); ++c) {
+            int wordRarity = m_word(m_sorted[w]).rarity;
+            for (std::size_t c = 0; c < m_word(m_sorted[w]).text.length(); ++c) {
                 if (c >= m_grid[w].size()) continue;
 
                 sf::Vector2f p_tile = m_tilePos(static_cast<int>(w), static_cast<int>(c));
@@ -3176,7 +2954,8 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
     // --- Draw Path Lines ---
     if (m_dragging && !m_path.empty() && !m_wheelLetterRenderPos.empty()) {
         const float halfThickness = scaledPathThickness / 2.0f;
-        const sf::Color pathColor = m_currentTheme.gridLetter;
+        // Segments past the point where no puzzle word matches any more are drawn as a dead end
+        const sf::Color livePathColor = m_currentTheme.gridLetter;
 
         if (m_path.size() >= 2) {
             sf::VertexArray finalPathStrip(sf::PrimitiveType::TriangleStrip);
@@ -3189,6 +2968,7 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
                     if (length < 0.1f) continue;
                     sf::Vector2f unitPerpendicular = { -direction.y / length, direction.x / length };
                     sf::Vector2f offset = unitPerpendicular * halfThickness;
+                    const sf::Color pathColor = m_guessPrefixAlive(i + 2) ? livePathColor : GUESS_DEAD_END_COLOR;
                     finalPathStrip.append(sf::Vertex(p1 - offset, pathColor));
                     finalPathStrip.append(sf::Vertex(p1 + offset, pathColor));
                     finalPathStrip.append(sf::Vertex(p2 - offset, pathColor));
@@ -3205,6 +2985,7 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
             if (length > 0.1f) {
                 sf::Vector2f unitPerpendicular = { -direction.y / length, direction.x / length };
                 sf::Vector2f offset = unitPerpendicular * halfThickness;
+                const sf::Color pathColor = m_guessPrefixAlive(m_path.size()) ? livePathColor : GUESS_DEAD_END_COLOR;
                 sf::VertexArray rubberBandStrip(sf::PrimitiveType::TriangleStrip, 4);
                 rubberBandStrip[0].position = p1 - offset; rubberBandStrip[0].color = pathColor;
                 rubberBandStrip[1].position = p1 + offset; rubberBandStrip[1].color = pathColor;
@@ -3303,7 +3084,6 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
 
         const unsigned int guessLetterFontSize = static_cast<unsigned int>(std::max(8.0f, guessTileSize * GUESS_LETTER_FONT_SCALE));
         m_guessDisplay_Text->setCharacterSize(guessLetterFontSize);
-        m_guessDisplay_Text->setFillColor(m_currentTheme.gridLetter);
 
         if (m_buttonSpr && m_buttonTex.getSize().x > 0) {
             m_buttonSpr->setOrigin(sf::Vector2f(0.f, 0.f));
@@ -3315,7 +3095,8 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
                 m_buttonSpr->setPosition(sf::Vector2f(tileLeft, guessRowTopY));
                 m_window.draw(*m_buttonSpr);
 
-                // Draw letter centered in this button
+                // Draw letter centered in this button, dimmed once the prefix leads to no puzzle word
+                m_guessDisplay_Text->setFillColor(m_guessPrefixAlive(i + 1) ? m_currentTheme.gridLetter : GUESS_DEAD_END_COLOR);
                 m_guessDisplay_Text->setString(std::string(1, m_currentGuess[i]));
                 sf::FloatRect letterBounds = m_guessDisplay_Text->getLocalBounds();
                 m_guessDisplay_Text->setOrigin(sf::Vector2f(
@@ -3334,7 +3115,7 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
     // --- Hint Zone UI (Left Side) ---
     if (m_bonusWordsInHintZoneText) {
         int totalPossibleBonus = m_calculateTotalPossibleBonusWords();
-        std::string bonusTextStr = "Bonus Words: " + std::to_string(m_foundBonusWords.size()) + "/" + std::to_string(totalPossibleBonus);
+        std::string bonusTextStr = "Bonus Words: " + std::to_string(m_puzzleWords.foundBonusCount()) + "/" + std::to_string(totalPossibleBonus);
         m_bonusWordsInHintZoneText->setString(bonusTextStr);
         m_bonusWordsInHintZoneText->setFillColor(GLOWING_TUBE_TEXT_COLOR);
 
@@ -3431,7 +3212,8 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
 
     // --- Solved Word Info Popup (hovered grid word) ---
     if (m_hoveredSolvedWordIndex != -1 && m_popupWordText && m_popupPosText && m_popupDefinitionText && m_popupSentenceText) {
-        const WordInfo& info = m_sorted[m_hoveredSolvedWordIndex];
+        const WordInfo& info = m_word(m_sorted[m_hoveredSolvedWordIndex]);
+        const Words::WordDetails& details = m_wordDetails.get(info.detailsId);
 
         const float popupPadding = S(this, WORD_INFO_POPUP_PADDING_DESIGN);
         const float popupMaxWidth = S(this, WORD_INFO_POPUP_MAX_WIDTH_DESIGN);
@@ -3447,9 +3229,9 @@ void Game::m_renderGameScreen(const sf::Vector2f& mousePos) {
         m_popupSentenceText->setCharacterSize(bodyFontSize);
 
         const std::string wordLine = "Word: " + info.text;
-        const std::string posLine = "POS: " + (info.pos.empty() ? "N/A" : info.pos);
-        const std::string defLine = "Definition: " + (info.definition.empty() ? "N/A" : info.definition);
-        const std::string sentenceLine = "Sentence: " + (info.sentence.empty() ? "N/A" : info.sentence);
+        const std::string posLine = "POS: " + (details.pos.empty() ? "N/A" : details.pos);
+        const std::string defLine = "Definition: " + (details.definition.empty() ? "N/A" : details.definition);
+        const std::string sentenceLine = "Sentence: " + (details.sentence.empty() ? "N/A" : details.sentence);
 
         m_popupWordText->setString(wrapTextForWidth(*m_popupWordText, wordLine, contentWidthLimit));
         m_popupPosText->setString(wrapTextForWidth(*m_popupPosText, posLine, contentWidthLimit));
@@ -3973,7 +3755,7 @@ void Game::m_activateHint(HintType type) {
 
     bool anyBlanksLeft = false;
     for (std::size_t w = 0; w < m_grid.size() && w < m_sorted.size(); ++w) {
-        if (!m_found.count(m_sorted[w].text)) { // Only check unsolved words
+        if (!m_puzzleWords.isGridFound(w)) { // Only check unsolved words
             for (char gridChar : m_grid[w]) {
                 if (gridChar == '_') {
                     anyBlanksLeft = true;
@@ -4007,8 +3789,8 @@ void Game::m_activateHint(HintType type) {
 
         // Find first unsolved word
         for (std::size_t w = 0; w < m_grid.size() && w < m_sorted.size(); ++w) {
-            const std::string& solutionWord = m_sorted[w].text;
-            if (!m_found.count(solutionWord)) { // Is it unsolved?
+            const std::string& solutionWord = m_word(m_sorted[w]).text;
+            if (!m_puzzleWords.isGridFound(w)) { // Is it unsolved?
                 // Find first blank in this word
                 for (std::size_t c = 0; c < m_grid[w].size(); ++c) {
                     if (m_grid[w][c] == '_') {
@@ -4048,8 +3830,8 @@ void Game::m_activateHint(HintType type) {
         // Iterate through each word in the grid
         for (std::size_t w = 0; w < m_grid.size() && w < m_sorted.size(); ++w) {
             // Check if this word is unsolved
-            if (!m_found.count(m_sorted[w].text)) {
-                const std::string& solutionWord = m_sorted[w].text;
+            if (!m_puzzleWords.isGridFound(w)) {
+                const std::string& solutionWord = m_word(m_sorted[w]).text;
                 std::vector<int> blankIndicesInThisWord; // Store indices of blanks for *this* word
 
                 // Find all blank spots in *this specific* unsolved word
@@ -4105,14 +3887,14 @@ void Game::m_activateHint(HintType type) {
         int lastUnsolvedWordIdx = -1;
 
         for (int w = static_cast<int>(m_grid.size()) - 1; w >= 0; --w) {
-            if (w < m_sorted.size() && !m_found.count(m_sorted[w].text)) {
+            if (w < m_sorted.size() && !m_puzzleWords.isGridFound(w)) {
                 lastUnsolvedWordIdx = w;
                 break;
             }
         }
 
         if (lastUnsolvedWordIdx != -1) {
-            const std::string& solutionWord = m_sorted[lastUnsolvedWordIdx].text;
+            const std::string& solutionWord = m_word(m_sorted[lastUnsolvedWordIdx]).text;
             bool anyRevealedInThisWord = false;
             for (std::size_t c = 0; c < m_grid[lastUnsolvedWordIdx].size(); ++c) {
                 if (m_grid[lastUnsolvedWordIdx][c] == '_') {
@@ -4145,8 +3927,8 @@ void Game::m_activateHint(HintType type) {
         bool actionTakenForThisHint = false;
 
         for (std::size_t w = 0; w < m_grid.size() && w < m_sorted.size(); ++w) {
-            if (!m_found.count(m_sorted[w].text)) { // If word is unsolved
-                const std::string& solutionWord = m_sorted[w].text;
+            if (!m_puzzleWords.isGridFound(w)) { // If word is unsolved
+                const std::string& solutionWord = m_word(m_sorted[w]).text;
                 int firstBlankCharIdxInThisWord = -1;
 
                 // Find the *first* blank spot in this specific unsolved word
@@ -4258,10 +4040,10 @@ void Game::m_checkWordCompletion(int wordIdx) {
         return;
     }
 
-    const std::string& solutionWord = m_sorted[wordIdx].text;
+    const std::string& solutionWord = m_word(m_sorted[wordIdx]).text;
 
     // If this word is already found, do nothing
-    if (m_found.count(solutionWord)) {
+    if (m_puzzleWords.isGridFound(wordIdx)) {
         return;
     }
 
@@ -4286,10 +4068,10 @@ void Game::m_checkWordCompletion(int wordIdx) {
 
         if (gridWordUpper == solutionWordUpper) {
             std::cout << "DEBUG: Word '" << solutionWord << "' completed by hint/auto-reveal." << std::endl;
-            m_found.insert(solutionWord);
+            m_puzzleWords.markFound(static_cast<std::uint32_t>(wordIdx));
 
             int baseScore = static_cast<int>(solutionWord.length()) * 10;
-            int rarityBonus = (m_sorted[wordIdx].rarity > 1) ? (m_sorted[wordIdx].rarity * 25) : 0;
+            int rarityBonus = (m_word(m_sorted[wordIdx]).rarity > 1) ? (m_word(m_sorted[wordIdx]).rarity * 25) : 0;
             int wordScoreForThisWord = baseScore + rarityBonus; // <<< NEW LINE
 
             m_currentScore += wordScoreForThisWord;
@@ -4299,11 +4081,11 @@ void Game::m_checkWordCompletion(int wordIdx) {
                 m_scoreValueText->setString(std::to_string(m_currentScore));
             }
 
-            std::cout << "HINT-COMPLETED Word: " << solutionWord << " | Rarity: " << m_sorted[wordIdx].rarity
+            std::cout << "HINT-COMPLETED Word: " << solutionWord << " | Rarity: " << m_word(m_sorted[wordIdx]).rarity
                 << " | Len: " << solutionWord.length() << " | Rarity Bonus: " << rarityBonus
                 << " | BasePts: " << baseScore << " | Total: " << m_currentScore << std::endl;
 
-            if (m_found.size() == m_solutions.size()) {
+            if (m_puzzleWords.allGridFound()) {
                 std::cout << "DEBUG: All grid words found (via hint)! Puzzle solved." << std::endl;
                 if (m_winSound) m_winSound->play();
                 m_gameState = GState::Solved;
@@ -4328,7 +4110,7 @@ void Game::m_spawnScoreFlourish(int points, int wordIdxOnGrid) {
     particle.color = sf::Color(255, 215, 0, 255); // Gold-like color, full alpha initially
 
     // 2. Determine Initial Position
-    const std::string& solvedWordText = m_sorted[wordIdxOnGrid].text;
+    const std::string& solvedWordText = m_word(m_sorted[wordIdxOnGrid]).text;
     if (solvedWordText.empty()) { /* ... error handling ... */ return; }
     if (static_cast<int>(solvedWordText.length()) - 1 < 0) { /* ... error handling ... */ return; }
 
@@ -4506,12 +4288,7 @@ void Game::m_renderHintPointAnims(sf::RenderTarget& target) {
 // Helper function (can be a private static method or in an anonymous namespace if preferred)
 // to check if a word is a main grid solution.
 bool Game::isGridSolution(const std::string& wordText) const { // Ensure Game:: is present
-    for (const auto& solInfo : m_solutions) { // m_solutions is a member
-        if (solInfo.text == wordText) {
-            return true;
-        }
-    }
-    return false;
+    return m_puzzleWords.isGrid(wordText); // Hash lookup in the per-puzzle table
 }
 
 void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
@@ -4533,16 +4310,18 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
     // --- 1. Prepare Data (Caching) ---
     if (!m_bonusWordsCacheIsValid) {
         m_cachedBonusWords.clear();
-        std::set<std::string> uniqueBonusWordTexts;
-        for (const auto& wordInfo : m_allPotentialSolutions) {
-            if (!isGridSolution(wordInfo.text)) {
-                if (uniqueBonusWordTexts.insert(wordInfo.text).second) {
-                    m_cachedBonusWords.push_back(wordInfo);
-                }
+        m_cachedBonusWords.reserve(m_puzzleWords.bonusCount());
+        for (std::size_t b = 0; b < m_allPotentialSolutions.size(); ++b) {
+            // Each bonus entry points at the first occurrence of its text
+            const PuzzleWordTable::Entry& entry = m_puzzleWords.entry(m_puzzleWords.find(m_word(m_allPotentialSolutions[b]).text));
+            if (entry.kind == PuzzleWordTable::Kind::Bonus && entry.index == b) {
+                m_cachedBonusWords.push_back(m_allPotentialSolutions[b]);
             }
         }
         std::sort(m_cachedBonusWords.begin(), m_cachedBonusWords.end(),
-            [](const WordInfo& a, const WordInfo& b) {
+            [this](WordId idA, WordId idB) {
+                const WordInfo& a = m_word(idA);
+                const WordInfo& b = m_word(idB);
                 if (a.text.length() != b.text.length()) return a.text.length() < b.text.length();
                 return a.text < b.text;
             });
@@ -4550,9 +4329,9 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
     }
     if (m_cachedBonusWords.empty()) return;
 
-    std::map<int, std::vector<WordInfo>> bonusWordsByLength;
-    for (const auto& wi : m_cachedBonusWords) {
-        bonusWordsByLength[static_cast<int>(wi.text.length())].push_back(wi);
+    std::map<int, std::vector<WordId>> bonusWordsByLength;
+    for (WordId id : m_cachedBonusWords) {
+        bonusWordsByLength[static_cast<int>(m_word(id).text.length())].push_back(id);
     }
 
     // --- 2. Determine Internal Text Scale based on Design Units ---
@@ -4568,7 +4347,7 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
     bool firstMajorColEst = true;
     for (const auto& pair_len_words : bonusWordsByLength) {
         int length = pair_len_words.first;
-        const std::vector<WordInfo>& words = pair_len_words.second;
+        const std::vector<WordId>& words = pair_len_words.second;
         if (words.empty()) continue;
 
         if (!firstMajorColEst) estimatedTotalContentWidthDU += MAJOR_COL_SPACING_BASE;
@@ -4589,7 +4368,7 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
         for (int k = 0; k < wordsInLongestMinorColEst; ++k) {
             if (k >= words.size()) break; // if estimation is too large
             // Use a representative string for estimation (e.g., all '*' or an actual word if available)
-            std::string est_disp = std::string(words[k].text.length(), '*');
+            std::string est_disp = std::string(m_word(words[k]).text.length(), '*');
             measureText.setString(est_disp); // Use estimated display
             measureText.setCharacterSize(POPUP_WORD_FONT_SIZE_BASE);
             sf::FloatRect wordB = measureText.getLocalBounds();
@@ -4599,7 +4378,8 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
         currentGroupHeightEst += currentMinorColHeightEst;
 
 
-        for (const auto& wordInfo : words) {
+        for (WordId wordId : words) {
+            const WordInfo& wordInfo = m_word(wordId);
             std::string tempDisp = std::string(wordInfo.text.length(), '*');
             measureText.setString(tempDisp);
             measureText.setCharacterSize(POPUP_WORD_FONT_SIZE_BASE);
@@ -4639,7 +4419,7 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
     bool firstMajorColDraw = true;
     for (const auto& pair_len_words : bonusWordsByLength) {
         int length = pair_len_words.first;
-        const std::vector<WordInfo>& wordsInGroup = pair_len_words.second;
+        const std::vector<WordId>& wordsInGroup = pair_len_words.second;
         if (wordsInGroup.empty()) continue;
 
         if (!firstMajorColDraw) finalActualContentWidthDU += actualMajorColSpacingDU;
@@ -4655,9 +4435,10 @@ void Game::m_renderBonusWordsPopup(sf::RenderTarget& target) {
 
         float maxWordTextWidthThisGroupDU = 0.f;
         std::vector<PopupDrawItem> wordsToDistribute;
-        for (const auto& wordInfo : wordsInGroup) {
+        for (WordId wordId : wordsInGroup) {
+            const WordInfo& wordInfo = m_word(wordId);
             std::string displayText;
-            bool isFound = m_foundBonusWords.count(wordInfo.text);
+            bool isFound = m_puzzleWords.isFound(m_puzzleWords.find(wordInfo.text));
             if (isFound) { displayText = wordInfo.text; std::transform(displayText.begin(), displayText.end(), displayText.begin(), ::toupper); }
             else { displayText = std::string(wordInfo.text.length(), '*'); }
             measureText.setString(displayText);
@@ -4851,13 +4632,7 @@ int Game::m_calculateTotalPossibleBonusWords() const {
     if (m_base == "ERROR" || m_allPotentialSolutions.empty()) {
         return 0;
     }
-    int count = 0;
-    for (const auto& wordInfo : m_allPotentialSolutions) {
-        if (!isGridSolution(wordInfo.text)) { // isGridSolution helper is already defined
-            count++;
-        }
-    }
-    return count;
+    return static_cast<int>(m_puzzleWords.bonusCount());
 }
 
 void Game::m_triggerBonusListCompleteEffect(int pointsAwarded) {
@@ -26,22 +26,23 @@
 #include "DecorLayer.h"
 #include "Constants.h" // Include constants used in the header (like GRID_TOP_MARGIN default)
 #include "Crossword.h"
+#include "CrosswordCache.h"
+#include "Words.h"
+#include "WordDawg.h"
+#include "RootPool.h"
+#include "PuzzleGenerator.h"
+#include "PuzzleWordTable.h"
 
 // Standard Library Headers needed for declarations
 #include <vector>
 #include <string>
-#include <set>
 #include <map>
 #include <memory> 
+#include <future>
+#include <random>
+#include <cstdint>
 
-enum class GameMode { Casual, Crossword };
-
-enum class DifficultyLevel {
-    None, // Default state or for modes without difficulty
-    Easy,
-    Medium,
-    Hard
-};
+// GameMode and DifficultyLevel live in PuzzleRules.h (via Constants.h)
 
 // Add an enum for Hint Types
 enum class HintType { RevealFirst, RevealRandom, RevealLast, RevealFirstOfEach };
@@ -55,6 +56,7 @@ public:
     // ... (public methods like Game(), run(), etc.) ...
     void m_updateView(sf::Vector2u win); // Already exists
     Game(); // Constructor
+    ~Game(); // Waits for a puzzle still being prefetched
     void run(); // Main game loop function
     friend float S(const Game* g, float du);
 
@@ -138,8 +140,8 @@ private:
 
     bool m_debugDrawCircleMode;
     float m_currentGridLayoutScale = 1.0f;
-    std::set<std::string> m_usedBaseWordsThisSession;
-    std::set<std::string> m_usedLetterSetsThisSession;
+    std::vector<bool> m_usedAnagramClassesThisSession; // Bitset over WordInfo::anagramClass
+    std::size_t m_anagramClassCount = 0;
     float m_uiScale = 1.f;
     bool m_needsLayoutUpdate;
     sf::Vector2u m_lastKnownSize;
@@ -152,12 +154,15 @@ private:
 
     // Crossword mode data
     std::vector<CrosswordPlacement> m_crosswordPlacements;
-    std::map<std::pair<int,int>, std::vector<std::pair<int,int>>> m_crosswordSharedCells;
+    CrosswordCellTable m_crosswordCells; // Shared-cell owners per letter, rebuilt with each layout
     int m_crosswordGridRows = 0;
     int m_crosswordGridCols = 0;
 
-    std::vector<WordInfo> m_allPotentialSolutions;
-    std::set<std::string> m_foundBonusWords;
+    std::vector<WordId> m_allPotentialSolutions; // Puzzle word lists are ids into m_fullWordList
+    PuzzleWordTable m_puzzleWords; // Grid/bonus lookup and found state, rebuilt with each puzzle
+
+    Words::WordDawg m_puzzleDawg; // Grid and bonus words of the current puzzle, for prefix feedback while dragging
+    std::vector<std::uint32_t> m_guessEntries; // m_puzzleWords entry per m_puzzleDawg ordinal
     std::vector<HintPointAnimParticle> m_hintPointAnims;
     float m_hintPointsTextFlourishTimer;
 
@@ -175,14 +180,20 @@ private:
     bool m_isAwaitingLetterHintTarget = false;
     std::vector<int> m_path;
     std::string m_currentGuess;
-
-    std::vector<WordInfo> m_fullWordList;
-    std::vector<WordInfo> m_roots;
+    // m_puzzleDawg cursor after each letter of m_currentGuess, so backtracking is a pop;
+    // dead once no puzzle word starts with the guess
+    std::vector<Words::WordDawg::Cursor> m_guessSteps;
+
+    std::vector<WordInfo> m_fullWordList; // Not changed after loading; puzzle state keeps ids into it
+    Words::WordDetailsStore m_wordDetails; // POS/definition/sentence for the popup, fetched on hover
+    Words::SubWordIndex m_subWordIndex; // Letter signatures for m_fullWordList, built once at load
+    Words::RootPool m_rootPool; // Base-word candidates, bucketed once at load
+    PuzzleGenerator m_puzzleGenerator{ m_fullWordList, m_subWordIndex, m_rootPool }; // UI-free puzzle construction
+    CrosswordCache m_crosswordCache; // Best known layouts, loaded at startup and saved on exit
     std::string m_base;
-    std::vector<WordInfo> m_solutions;
-    std::vector<WordInfo> m_sorted;
+    std::vector<WordId> m_solutions;
+    std::vector<WordId> m_sorted;
     std::vector<std::vector<char>> m_grid;
-    std::set<std::string> m_found;
 
     std::vector<LetterAnim> m_anims;
     std::vector<ScoreParticleAnim> m_scoreAnims;
@@ -300,11 +311,19 @@ private:
     std::vector<ColorTheme> m_themes;
     ColorTheme m_currentTheme;
 
-    struct PuzzleCriteria {
-        std::vector<int> allowedLengths;
-        std::vector<int> allowedRarities;
-    };
-    PuzzleCriteria m_getCriteriaForCurrentPuzzle() const;
+    PuzzleRequest m_makePuzzleRequest(int puzzleIndex) const;
+    void m_applyPuzzle(Puzzle&& puzzle);
+    void m_startPuzzlePrefetch();
+    void m_cancelPuzzlePrefetch();
+    void m_startCrosswordImprovement(std::vector<WordId> words);
+    void m_pollCrosswordImprovement();
+
+    std::future<Puzzle> m_prefetchedPuzzle;  // Next puzzle of the session, built on the thread pool
+    PuzzleRequest m_prefetchedRequest;       // Request it was built from (its key is logged when it is used)
+    std::uint64_t m_prefetchedSerial = 0;    // m_sessionSerial it was built in
+    std::future<bool> m_crosswordImprovement; // Extra layout trials for the current word set (see CrosswordCache::improve)
+    std::vector<WordId> m_pendingCrosswordImprovement; // Word set whose improvement waits for the prefetch to finish
+    std::uint64_t m_sessionSerial = 0;              // Bumped at every session start
 
     RoundedRectangleShape m_progressMeterBg;
     RoundedRectangleShape m_progressMeterFill;
@@ -320,7 +339,7 @@ private:
     bool m_showDebugZones;
 
     bool m_isHoveringHintPointsText;
-    std::vector<WordInfo> m_cachedBonusWords;
+    std::vector<WordId> m_cachedBonusWords;
     bool m_bonusWordsCacheIsValid;
     float m_bonusWordsPopupScrollOffset;   // current scroll position (design units) for bonus words popup
     float m_bonusWordsPopupMaxScrollOffset; // max scroll (set during render when content is taller than popup)
@@ -342,6 +361,7 @@ private:
 
     void m_renderBonusWordsPopup(sf::RenderTarget& target);
     bool isGridSolution(const std::string& wordText) const;
+    const WordInfo& m_word(WordId id) const { return m_fullWordList[id]; }
 
     void m_loadResources();
     void m_processEvents();
@@ -354,6 +374,10 @@ private:
     void m_updateScoreAnims(float dt);
     sf::Vector2f m_tilePos(int wordIdx, int charIdx);
     void m_clearDragState();
+    void m_pushGuessLetter(int baseIndex);
+    void m_popGuessLetter();
+    std::uint32_t m_currentGuessEntry() const;
+    bool m_guessPrefixAlive(std::size_t letters) const;
     void m_clearPendingLetterHintTarget();
     bool m_isValidLetterHintTargetTile(int wordIdx, int charIdx) const;
     bool m_revealSpecificGridLetter(int wordIdx, int charIdx);
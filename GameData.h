@@ -9,6 +9,7 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <vector>
+#include "WordInfo.h" // WordInfo lives in its own SFML-free header (shared with the command-line tools)
 
 enum class AnimTarget {
     Grid,
@@ -42,39 +43,6 @@ struct Balloon {
 };
 
 
-//--------------------------------------------------------------------
-//  Word Data Structure
-//--------------------------------------------------------------------
-// Structure to hold word data including rarity and pre-calculated metrics
-struct WordInfo {
-    std::string text = "";
-    int rarity = 0;
-    std::string pos = "";
-    std::string definition = "";
-    std::string sentence = "";
-
-    // --- NEW Pre-calculated Metrics ---
-    float avgSubLen = 0.0f;         // Average length of sub-words (>= MIN_SUB_WORD_LEN)
-    int countGE3 = 0;               // Count of sub-words with length >= 3
-    int countGE4 = 0;               // Count of sub-words with length >= 4
-    int countGE5 = 0;               // Count of sub-words with length >= 5
-    int easyValidCount = 0;         // Count valid for Easy difficulty criteria
-    int mediumValidCount = 0;       // Count valid for Medium difficulty criteria
-    int hardValidCount = 0;         // Count valid for Hard difficulty criteria
-
-    // Optional: Constructor for easier initialization if needed
-    WordInfo() = default; // Keep default constructor
-
-    // Example constructor if you want to set everything at once
-    WordInfo(std::string t, int r, std::string p = "", std::string def = "", std::string sent = "",
-        float avgSL = 0.0f, int c3 = 0, int c4 = 0, int c5 = 0, int ec = 0, int mc = 0, int hc = 0)
-        : text(std::move(t)), rarity(r), pos(std::move(p)), definition(std::move(def)),
-        sentence(std::move(sent)), avgSubLen(avgSL), countGE3(c3), countGE4(c4),
-        countGE5(c5), easyValidCount(ec), mediumValidCount(mc), hardValidCount(hc) {
-    }
-
-};
-
 struct ScoreFlourishParticle {
     std::string textString;     // e.g., "+40"
     sf::Vector2f position;      // Current position for rendering
@@ -0,0 +1,200 @@
+#include "HistogramKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define WORDS_HISTOGRAM_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang only emit AVX2 code in functions marked for it; MSVC always can
+#if defined(WORDS_HISTOGRAM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define WORDS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WORDS_TARGET_AVX2
+#endif
+
+namespace Words {
+
+    namespace {
+
+        // Letter slots the base actually has. Any other letter is rejected by the
+        // presence mask, so only these rows need a count compare.
+        struct BaseQuery {
+            std::uint32_t excluded = 0; // Letters (and unused high bits) the base lacks
+            int slotCount = 0;
+            int slots[HistogramTable::SLOTS];
+            std::uint8_t counts[HistogramTable::SLOTS];
+        };
+
+        BaseQuery makeQuery(const std::array<std::uint8_t, 26>& baseCounts) {
+            BaseQuery query;
+            std::uint32_t mask = 0;
+            for (int slot = 0; slot < HistogramTable::SLOTS; ++slot) {
+                if (baseCounts[slot] == 0) continue;
+                mask |= 1u << slot;
+                query.slots[query.slotCount] = slot;
+                query.counts[query.slotCount] = baseCounts[slot];
+                query.slotCount++;
+            }
+            query.excluded = ~mask;
+            return query;
+        }
+
+        void fitsScalar(const BaseQuery& query, const std::uint32_t* masks, const std::uint8_t* counts,
+            std::size_t stride, std::uint32_t* out) {
+            for (std::size_t block = 0; block < stride / HistogramTable::BLOCK_WORDS; ++block) {
+                std::uint32_t bits = 0;
+                for (std::size_t j = 0; j < HistogramTable::BLOCK_WORDS; ++j) {
+                    const std::size_t word = block * HistogramTable::BLOCK_WORDS + j;
+                    if ((masks[word] & query.excluded) != 0) continue;
+                    bool fits = true;
+                    for (int s = 0; s < query.slotCount && fits; ++s) {
+                        fits = counts[query.slots[s] * stride + word] <= query.counts[s];
+                    }
+                    if (fits) bits |= 1u << j;
+                }
+                out[block] = bits;
+            }
+        }
+
+#if defined(WORDS_HISTOGRAM_X86)
+        void fitsSse2(const BaseQuery& query, const std::uint32_t* masks, const std::uint8_t* counts,
+            std::size_t stride, std::uint32_t* out) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i excluded = _mm_set1_epi32(static_cast<int>(query.excluded));
+            for (std::size_t block = 0; block < stride / HistogramTable::BLOCK_WORDS; ++block) {
+                const std::size_t first = block * HistogramTable::BLOCK_WORDS;
+
+                // Presence masks, 4 words per compare
+                std::uint32_t bits = 0;
+                for (int q = 0; q < 8; ++q) {
+                    const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + first + q * 4));
+                    const __m128i ok = _mm_cmpeq_epi32(_mm_and_si128(m, excluded), zero);
+                    bits |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(ok))) << (q * 4);
+                }
+                if (bits == 0) { out[block] = 0; continue; }
+
+                // Counts of the base's letters, 16 words per compare
+                __m128i badLo = zero, badHi = zero;
+                for (int s = 0; s < query.slotCount; ++s) {
+                    const std::uint8_t* row = counts + query.slots[s] * stride + first;
+                    const __m128i limit = _mm_set1_epi8(static_cast<char>(query.counts[s]));
+                    badLo = _mm_or_si128(badLo, _mm_subs_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)), limit));
+                    badHi = _mm_or_si128(badHi, _mm_subs_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16)), limit));
+                }
+                const std::uint32_t countOk = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(badLo, zero)))
+                    | (static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(badHi, zero))) << 16);
+                out[block] = bits & countOk;
+            }
+        }
+
+        WORDS_TARGET_AVX2
+        void fitsAvx2(const BaseQuery& query, const std::uint32_t* masks, const std::uint8_t* counts,
+            std::size_t stride, std::uint32_t* out) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i excluded = _mm256_set1_epi32(static_cast<int>(query.excluded));
+            for (std::size_t block = 0; block < stride / HistogramTable::BLOCK_WORDS; ++block) {
+                const std::size_t first = block * HistogramTable::BLOCK_WORDS;
+
+                // Presence masks, 8 words per compare
+                std::uint32_t bits = 0;
+                for (int q = 0; q < 4; ++q) {
+                    const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + first + q * 8));
+                    const __m256i ok = _mm256_cmpeq_epi32(_mm256_and_si256(m, excluded), zero);
+                    bits |= static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(ok))) << (q * 8);
+                }
+                if (bits == 0) { out[block] = 0; continue; }
+
+                // Counts of the base's letters, 32 words per compare
+                __m256i bad = zero;
+                for (int s = 0; s < query.slotCount; ++s) {
+                    const __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + query.slots[s] * stride + first));
+                    bad = _mm256_or_si256(bad, _mm256_subs_epu8(row, _mm256_set1_epi8(static_cast<char>(query.counts[s]))));
+                }
+                out[block] = bits & static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bad, zero)));
+            }
+        }
+#endif
+
+        SimdLevel detectOnce() {
+#if defined(WORDS_HISTOGRAM_X86)
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx2 = false;
+            if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) { // OS saves the YMM registers
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            const bool sse2 = __builtin_cpu_supports("sse2") != 0;
+            const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+            if (avx2) return SimdLevel::AVX2;
+            if (sse2) return SimdLevel::SSE2;
+#endif
+            return SimdLevel::Scalar;
+        }
+
+    } // namespace
+
+
+    SimdLevel detectSimdLevel() {
+        static const SimdLevel level = detectOnce();
+        return level;
+    }
+
+
+    const char* simdLevelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default:              return "scalar";
+        }
+    }
+
+
+    void HistogramTable::assign(std::size_t wordCount) {
+        m_size = wordCount;
+        m_stride = (wordCount + BLOCK_WORDS - 1) / BLOCK_WORDS * BLOCK_WORDS;
+        m_masks.assign(m_stride, ~0u); // Padding never fits: some excluded bit is always set
+        m_counts.assign(static_cast<std::size_t>(SLOTS) * m_stride, 0);
+    }
+
+
+    void HistogramTable::set(std::size_t word, const std::array<std::uint8_t, 26>& counts) {
+        std::uint32_t mask = 0;
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            m_counts[slot * m_stride + word] = counts[slot];
+            if (counts[slot] != 0) mask |= 1u << slot;
+        }
+        m_masks[word] = mask;
+    }
+
+
+    void HistogramTable::fitsWithin(const std::array<std::uint8_t, 26>& baseCounts, std::vector<std::uint32_t>& out,
+        SimdLevel level) const {
+        out.assign(blockCount(), 0);
+        if (m_stride == 0) return;
+
+        const BaseQuery query = makeQuery(baseCounts);
+#if defined(WORDS_HISTOGRAM_X86)
+        if (level == SimdLevel::AVX2 && detectSimdLevel() == SimdLevel::AVX2) {
+            fitsAvx2(query, m_masks.data(), m_counts.data(), m_stride, out.data());
+            return;
+        }
+        if (level != SimdLevel::Scalar && detectSimdLevel() != SimdLevel::Scalar) {
+            fitsSse2(query, m_masks.data(), m_counts.data(), m_stride, out.data());
+            return;
+        }
+#else
+        (void)level;
+#endif
+        fitsScalar(query, m_masks.data(), m_counts.data(), m_stride, out.data());
+    }
+
+} // namespace Words
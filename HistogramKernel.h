@@ -0,0 +1,72 @@
+#pragma once
+#ifndef HISTOGRAMKERNEL_H
+#define HISTOGRAMKERNEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//--------------------------------------------------------------------
+//  Batch letter-histogram test (SIMD)
+//--------------------------------------------------------------------
+// The inner loop of sub-word queries: "does each letter count of word i fit
+// within the base's?" for a whole word list at once. Counts are stored
+// transposed (one row per letter a-z, one byte per word, padded to whole
+// 32-word blocks), so one vector compare checks a letter for 32 (AVX2) or 16
+// (SSE2) words. A presence-mask pass rejects words using letters the base
+// lacks first; only the base's own letters (7 at most for a root) need a
+// count compare. The kernel is picked at runtime from the CPU; the scalar one
+// covers other targets.
+namespace Words {
+
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    // Best kernel this CPU (and OS) supports, detected once
+    SimdLevel detectSimdLevel();
+    const char* simdLevelName(SimdLevel level);
+
+    class HistogramTable {
+    public:
+        static constexpr std::size_t BLOCK_WORDS = 32; // Words per bitmap entry
+        static constexpr int SLOTS = 26;
+
+        // 'wordCount' words with all counts zero
+        void assign(std::size_t wordCount);
+        void set(std::size_t word, const std::array<std::uint8_t, 26>& counts);
+
+        std::size_t size() const { return m_size; }
+        std::size_t blockCount() const { return m_stride / BLOCK_WORDS; }
+
+        // Bitmap of the words whose every count is <= baseCounts: bit (i % 32) of
+        // out[i / 32] for word i. 'out' is resized to blockCount(); bits past size() are 0.
+        void fitsWithin(const std::array<std::uint8_t, 26>& baseCounts, std::vector<std::uint32_t>& out) const {
+            fitsWithin(baseCounts, out, detectSimdLevel());
+        }
+        void fitsWithin(const std::array<std::uint8_t, 26>& baseCounts, std::vector<std::uint32_t>& out, SimdLevel level) const;
+
+    private:
+        std::size_t m_size = 0;
+        std::size_t m_stride = 0;           // Words per letter row, a multiple of BLOCK_WORDS
+        std::vector<std::uint32_t> m_masks; // Letters present per word; padding has every bit set
+        std::vector<std::uint8_t> m_counts; // SLOTS rows of m_stride bytes
+    };
+
+    // Index of the lowest set bit; 'bits' must not be 0
+    inline int lowestSetBit(std::uint32_t bits) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+} // namespace Words
+
+#endif // HISTOGRAMKERNEL_H
@@ -0,0 +1,430 @@
+#include "PuzzleGenerator.h"
+#include "Crossword.h"
+#include "PuzzleRules.h"
+#include "Seed.h"
+#include "Words.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+    // Independent random streams per stage (see Seed.h)
+    enum SeedStream : std::uint64_t {
+        BASE_DRAW_STREAM = 1,
+        SCRAMBLE_STREAM = 2,
+        CROSSWORD_STREAM = 3,
+    };
+
+    const char* difficultyKeyName(DifficultyLevel difficulty) {
+        switch (difficulty) {
+        case DifficultyLevel::Easy:   return "easy";
+        case DifficultyLevel::Medium: return "medium";
+        case DifficultyLevel::Hard:   return "hard";
+        default:                      return "none";
+        }
+    }
+
+} // namespace
+
+
+std::string puzzleKey(const PuzzleRequest& request) {
+    std::ostringstream key;
+    key << request.seed << ':' << difficultyKeyName(request.difficulty) << ':'
+        << (request.mode == GameMode::Crossword ? "crossword" : "casual");
+    if (request.puzzlesPerSession > 0) {
+        key << ':' << request.puzzleIndex << '/' << request.puzzlesPerSession;
+    }
+    const char* separator = ":used=";
+    for (std::size_t cls = 0; cls < request.usedAnagramClasses.size(); ++cls) {
+        if (!request.usedAnagramClasses[cls]) continue;
+        key << separator << cls;
+        separator = ",";
+    }
+    return key.str();
+}
+
+
+bool parsePuzzleKey(const std::string& key, PuzzleRequest& request) {
+    std::vector<std::string> parts;
+    std::stringstream stream(key);
+    for (std::string part; std::getline(stream, part, ':');) parts.push_back(part);
+
+    std::vector<bool> usedAnagramClasses;
+    const std::string usedPrefix = "used=";
+    if (!parts.empty() && parts.back().compare(0, usedPrefix.size(), usedPrefix) == 0) {
+        std::stringstream classes(parts.back().substr(usedPrefix.size()));
+        for (std::string cls; std::getline(classes, cls, ',');) {
+            char* clsEnd = nullptr;
+            const unsigned long id = std::strtoul(cls.c_str(), &clsEnd, 10);
+            if (cls.empty() || *clsEnd != '\0' || id >= WordInfo::NO_ANAGRAM_CLASS) return false;
+            if (id >= usedAnagramClasses.size()) usedAnagramClasses.resize(id + 1, false);
+            usedAnagramClasses[id] = true;
+        }
+        if (usedAnagramClasses.empty()) return false;
+        parts.pop_back();
+    }
+    if (parts.size() != 3 && parts.size() != 4) return false;
+
+    char* end = nullptr;
+    const unsigned long long seed = std::strtoull(parts[0].c_str(), &end, 10);
+    if (parts[0].empty() || *end != '\0') return false;
+
+    DifficultyLevel difficulty;
+    if (parts[1] == "easy") difficulty = DifficultyLevel::Easy;
+    else if (parts[1] == "medium") difficulty = DifficultyLevel::Medium;
+    else if (parts[1] == "hard") difficulty = DifficultyLevel::Hard;
+    else if (parts[1] == "none") difficulty = DifficultyLevel::None;
+    else return false;
+
+    GameMode mode;
+    if (parts[2] == "casual") mode = GameMode::Casual;
+    else if (parts[2] == "crossword") mode = GameMode::Crossword;
+    else return false;
+
+    int puzzleIndex = 0, puzzlesPerSession = 0;
+    if (parts.size() == 4) {
+        const std::size_t slash = parts[3].find('/');
+        if (slash == std::string::npos) return false;
+        puzzleIndex = std::atoi(parts[3].substr(0, slash).c_str());
+        puzzlesPerSession = std::atoi(parts[3].substr(slash + 1).c_str());
+        if (puzzleIndex < 0 || puzzlesPerSession <= puzzleIndex) return false;
+    }
+
+    request.seed = static_cast<std::uint64_t>(seed);
+    request.difficulty = difficulty;
+    request.mode = mode;
+    request.puzzleIndex = puzzleIndex;
+    request.puzzlesPerSession = puzzlesPerSession;
+    request.usedAnagramClasses = std::move(usedAnagramClasses);
+    return true;
+}
+
+PuzzleGenerator::PuzzleGenerator(const std::vector<WordInfo>& wordList, const Words::SubWordIndex& subWordIndex,
+    const Words::RootPool& rootPool)
+    : m_wordList(wordList), m_subWordIndex(subWordIndex), m_rootPool(rootPool) {
+}
+
+
+std::ostream& PuzzleGenerator::m_log() const {
+    if (m_verbose) return std::cout;
+    thread_local std::ostream discard(nullptr); // Per thread: writes only flip its own badbit
+    return discard;
+}
+
+
+// Same as Words::subWords(base, wordList, index), minus its unconditional debug line
+std::vector<WordId> PuzzleGenerator::m_findSubWords(const std::string& base) const {
+    std::vector<WordId> result;
+    if (base.empty()) return result;
+
+    std::vector<std::size_t> indices;
+    m_subWordIndex.findSubWords(base, m_wordList, indices);
+    result.reserve(indices.size());
+    for (std::size_t i : indices) {
+        result.push_back(static_cast<WordId>(i));
+    }
+    m_log() << "DEBUG: PuzzleGenerator found " << result.size() << " valid sub-words for base '" << base << "' (excluding base)." << std::endl;
+    return result;
+}
+
+
+PuzzleCriteria PuzzleGenerator::criteriaFor(const PuzzleRequest& request) {
+    PuzzleCriteria criteria;
+    bool isLastPuzzle = (request.puzzleIndex == request.puzzlesPerSession - 1);
+
+    switch (request.difficulty) {
+    case DifficultyLevel::Easy:
+        criteria.allowedRarities = { 1 }; // Primarily Rarity 1
+        criteria.allowedLengths = { 7 }; // Force 7-letter puzzles
+        break;
+
+    case DifficultyLevel::Medium:
+        criteria.allowedRarities = { 1, 2, 3 }; // Rarity 1, 2, or 3
+        criteria.allowedLengths = { 7 }; // Force 7-letter puzzles
+        break;
+
+    case DifficultyLevel::Hard:
+        criteria.allowedLengths = { 7 };   // Force 7-letter puzzles
+        if (isLastPuzzle) {
+            criteria.allowedRarities = { 4 };  // Last puzzle is Rarity 4
+        }
+        else {
+            criteria.allowedRarities = { 3, 4 };   // Rarity 3 or 4
+        }
+        break;
+
+    case DifficultyLevel::None: // Fallback or other modes
+    default:
+        // Default criteria (e.g., allow a wide range if not in a session)
+        criteria.allowedLengths = { 4, 5, 6, 7 }; // Or use WORD_LENGTH constant range
+        criteria.allowedRarities = { 1, 2, 3, 4 }; // All rarities
+        break;
+    }
+    return criteria;
+}
+
+
+Puzzle PuzzleGenerator::generate(const PuzzleRequest& request) const {
+    Puzzle puzzle;
+    std::mt19937 rng = seededRng(deriveSeed(request.seed, BASE_DRAW_STREAM));
+
+    int maxSolutionsForDifficulty = 0;
+    int minSubLengthForDifficulty = MIN_WORD_LENGTH;
+
+    // --- Base Word Selection (Collect Candidates, Pick Randomly) ---
+    std::string selectedBaseWord = "";
+    std::string baseWordForGrid = "";
+    WordId baseWordId = NO_WORD_ID;
+    bool baseWordFound = false;
+
+    if (m_rootPool.empty()) {
+        std::cerr << "Error: No root words available for puzzle generation.\n";
+        puzzle.base = "ERROR";
+    }
+    else {
+        PuzzleCriteria baseCriteria = criteriaFor(request);
+        if (request.mode == GameMode::Crossword) {
+            switch (request.difficulty) {
+            case DifficultyLevel::Easy:   maxSolutionsForDifficulty = CROSSWORD_EASY_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            case DifficultyLevel::Medium: maxSolutionsForDifficulty = CROSSWORD_MEDIUM_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            case DifficultyLevel::Hard:   maxSolutionsForDifficulty = CROSSWORD_HARD_MAX_SOLUTIONS; minSubLengthForDifficulty = HARD_MIN_WORD_LENGTH; break;
+            default: maxSolutionsForDifficulty = 999; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            }
+        } else {
+            switch (request.difficulty) {
+            case DifficultyLevel::Easy:   maxSolutionsForDifficulty = EASY_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            case DifficultyLevel::Medium: maxSolutionsForDifficulty = MEDIUM_MAX_SOLUTIONS; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            case DifficultyLevel::Hard:   maxSolutionsForDifficulty = HARD_MAX_SOLUTIONS; minSubLengthForDifficulty = HARD_MIN_WORD_LENGTH; break;
+            default: maxSolutionsForDifficulty = 999; minSubLengthForDifficulty = MIN_WORD_LENGTH; break;
+            }
+        }
+
+        // --- Print Status ---
+        m_log() << "Rebuilding Puzzle " << (request.puzzleIndex + 1) << "/" << request.puzzlesPerSession
+            << " (Difficulty: " << static_cast<int>(request.difficulty) << ") using pre-calculated metrics. Key: " << puzzleKey(request) << std::endl;
+        m_log() << "  Base Criteria: Lengths="; for (int l : baseCriteria.allowedLengths) m_log() << l << ","; m_log() << " Rarities="; for (int r : baseCriteria.allowedRarities) m_log() << r << ","; m_log() << std::endl;
+        m_log() << "  Sub Criteria for Final Filter: MinLen=" << minSubLengthForDifficulty << " MaxSol=" << maxSolutionsForDifficulty << std::endl;
+        m_log() << "  DEBUG: Current used anagram classes: " << std::count(request.usedAnagramClasses.begin(), request.usedAnagramClasses.end(), true) << std::endl;
+
+        // --- Draw From Pre-bucketed Root Pools ---
+        using Tier = Words::RootPool::Tier;
+        auto isUsed = [&request](const WordInfo& root) {
+            return root.anagramClass < request.usedAnagramClasses.size() && request.usedAnagramClasses[root.anagramClass];
+        };
+        const std::size_t idealPoolSize = m_rootPool.count(request.difficulty, Tier::Ideal, baseCriteria.allowedLengths, baseCriteria.allowedRarities);
+        const std::size_t fallbackPoolSize = m_rootPool.count(request.difficulty, Tier::Fallback, baseCriteria.allowedLengths, baseCriteria.allowedRarities);
+        m_log() << "DEBUG: Root pools for session criteria: " << idealPoolSize << " ideal and "
+            << fallbackPoolSize << " fallback candidates (used words rejected while drawing)." << std::endl;
+
+        std::uint32_t chosenIndex = m_rootPool.draw(request.difficulty, Tier::Ideal,
+            baseCriteria.allowedLengths, baseCriteria.allowedRarities, rng, isUsed);
+
+        if (chosenIndex != Words::RootPool::NO_ROOT) {
+            selectedBaseWord = m_rootPool.root(chosenIndex).text;
+            baseWordFound = true;
+            m_log() << "DEBUG: Randomly selected IDEAL candidate (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
+        }
+        else if ((chosenIndex = m_rootPool.draw(request.difficulty, Tier::Fallback,
+            baseCriteria.allowedLengths, baseCriteria.allowedRarities, rng, isUsed)) != Words::RootPool::NO_ROOT) {
+            // No unused ideal candidates, pick randomly from fallback candidates
+            selectedBaseWord = m_rootPool.root(chosenIndex).text;
+            baseWordFound = true;
+            m_log() << "DEBUG: No IDEAL words. Randomly selected FALLBACK candidate (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
+        }
+        else {
+            // No candidates met session criteria + unused checks. Apply BROAD fallback search.
+            m_log() << "DEBUG: No candidates met session criteria & unused checks. Applying BROAD fallback search..." << std::endl;
+            chosenIndex = m_rootPool.drawAny(rng, isUsed); // Any unused word/letter set qualifies
+
+            if (chosenIndex != Words::RootPool::NO_ROOT) {
+                selectedBaseWord = m_rootPool.root(chosenIndex).text;
+                baseWordFound = true;
+                m_log() << "DEBUG: Randomly selected BROAD FALLBACK candidate (Root Index: " << chosenIndex << "): '" << selectedBaseWord << "'" << std::endl;
+            }
+            else {
+                // Absolute last resort: ALL words/anagrams used
+                std::cerr << "CRITICAL FALLBACK: Cannot find ANY unused root word or letter set. Using a random one (may repeat)." << std::endl;
+                const std::uint32_t repeatIndex = std::uniform_int_distribution<std::uint32_t>(0, static_cast<std::uint32_t>(m_rootPool.size() - 1))(rng);
+                selectedBaseWord = m_rootPool.root(repeatIndex).text;
+                baseWordId = m_rootPool.rootId(repeatIndex);
+                baseWordFound = true;
+                // Don't add to used sets intentionally here, as it's a forced repeat
+            }
+        }
+
+        // Used sets are updated when the puzzle is applied (unless it was the absolute fallback)
+        puzzle.rootIndex = baseWordFound ? chosenIndex : Words::RootPool::NO_ROOT;
+        if (chosenIndex != Words::RootPool::NO_ROOT) baseWordId = m_rootPool.rootId(chosenIndex);
+
+        puzzle.base = selectedBaseWord; // Assign the final selected word (or "ERROR")
+        baseWordForGrid = selectedBaseWord; // Preserve original base before shuffle
+        puzzle.baseWord = selectedBaseWord;
+    } // End if (!m_rootPool.empty())
+
+
+    // Scramble the selected base word letters (only if valid)
+    if (puzzle.base != "ERROR" && !puzzle.base.empty()) {
+        std::mt19937 scrambleRng = seededRng(deriveSeed(request.seed, SCRAMBLE_STREAM));
+        std::shuffle(puzzle.base.begin(), puzzle.base.end(), scrambleRng);
+    }
+
+
+    // --- Sub-word Processing (Generate ONCE, Filter Unique, Sort, Truncate) ---
+    auto text = [this](WordId id) -> const std::string& { return m_wordList[id].text; };
+    auto gridOrder = [this](WordId idA, WordId idB) { // Longest, then most common, then alphabetical
+        const WordInfo& a = m_wordList[idA];
+        const WordInfo& b = m_wordList[idB];
+        if (a.text.length() != b.text.length()) return a.text.length() > b.text.length();
+        if (a.rarity != b.rarity) return a.rarity < b.rarity;
+        return a.text < b.text;
+    };
+
+    std::vector<WordId> final_solutions;
+    if (puzzle.base != "ERROR") {
+        puzzle.allPotentialSolutions = m_findSubWords(puzzle.base);
+        m_log() << "DEBUG: Generating final grid words for selected base letters (current base: '" << puzzle.base << "')." << std::endl;
+        std::vector<WordId> filtered_sub_solutions; // Initial filtering target
+        std::vector<int> allowedSubRarities;
+        int minSubRarity = 1, maxSubRarity = 4;
+        switch (request.difficulty) { /* ... set allowedSubRarities (see PuzzleRules.h) ... */
+        case DifficultyLevel::Easy:   minSubRarity = EASY_SUB_WORD_MIN_RARITY;   maxSubRarity = EASY_SUB_WORD_MAX_RARITY;   break;
+        case DifficultyLevel::Medium: minSubRarity = MEDIUM_SUB_WORD_MIN_RARITY; maxSubRarity = MEDIUM_SUB_WORD_MAX_RARITY; break;
+        case DifficultyLevel::Hard:   minSubRarity = HARD_SUB_WORD_MIN_RARITY;   maxSubRarity = HARD_SUB_WORD_MAX_RARITY;   break;
+        default: break;
+        }
+        for (int r = minSubRarity; r <= maxSubRarity; ++r) allowedSubRarities.push_back(r);
+
+        for (WordId subId : puzzle.allPotentialSolutions) { /* ... filter by length/rarity into filtered_sub_solutions ... */
+            const WordInfo& subInfo = m_wordList[subId];
+            if (subInfo.text.length() < static_cast<std::size_t>(minSubLengthForDifficulty)) continue;
+            bool subRarityMatch = false;
+            for (int subRarity : allowedSubRarities) { if (subInfo.rarity == subRarity) { subRarityMatch = true; break; } }
+            if (!subRarityMatch) continue;
+            filtered_sub_solutions.push_back(subId);
+        }
+        m_log() << "DEBUG: Found " << filtered_sub_solutions.size() << " potential grid words matching sub-word difficulty criteria." << std::endl;
+
+        // --- Ensure Uniqueness ---
+        m_log() << "DEBUG: Ensuring uniqueness of potential grid words..." << std::endl;
+        // Ids in list order, so the first of a run of equal texts is the first occurrence
+        std::vector<WordId> byText = filtered_sub_solutions;
+        std::sort(byText.begin(), byText.end(), [&text](WordId a, WordId b) {
+            if (text(a) != text(b)) return text(a) < text(b);
+            return a < b;
+            });
+        std::vector<WordId> unique_solutions_temp;
+        unique_solutions_temp.reserve(byText.size());
+        for (std::size_t i = 0; i < byText.size(); ++i) {
+            if (i == 0 || text(byText[i]) != text(byText[i - 1])) { unique_solutions_temp.push_back(byText[i]); }
+        }
+        m_log() << "DEBUG: Reduced to " << unique_solutions_temp.size() << " unique grid words." << std::endl;
+
+        // --- Sort Unique Solutions ---
+        m_log() << "DEBUG: Sorting unique solutions by length/rarity/alpha..." << std::endl;
+        std::sort(unique_solutions_temp.begin(), unique_solutions_temp.end(), gridOrder);
+
+        // --- Truncate Unique Solutions ---
+        if (unique_solutions_temp.size() > static_cast<std::size_t>(maxSolutionsForDifficulty)) {
+            m_log() << "DEBUG: Truncating unique sorted solutions from " << unique_solutions_temp.size() << " to " << maxSolutionsForDifficulty << std::endl;
+            unique_solutions_temp.resize(static_cast<std::size_t>(maxSolutionsForDifficulty));
+        }
+        else { m_log() << "DEBUG: No truncation needed for unique grid words." << std::endl; }
+
+        final_solutions = std::move(unique_solutions_temp); // Assign final unique list
+
+        // --- Ensure the base word itself is included in the grid list ---
+        if (!baseWordForGrid.empty()) {
+            std::string baseLower = baseWordForGrid;
+            std::transform(baseLower.begin(), baseLower.end(), baseLower.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+            bool baseAlreadyIncluded = false;
+            for (WordId id : final_solutions) {
+                if (text(id) == baseLower) {
+                    baseAlreadyIncluded = true;
+                    break;
+                }
+            }
+
+            if (!baseAlreadyIncluded) {
+                // First list entry with the lowercase text (roots keep list order within a
+                // length, so this is also the first such root); else the drawn root itself
+                WordId baseId = baseWordId;
+                for (std::size_t id = 0; id < m_wordList.size(); ++id) {
+                    if (m_wordList[id].text == baseLower) {
+                        baseId = static_cast<WordId>(id);
+                        break;
+                    }
+                }
+
+                if (baseId != NO_WORD_ID && text(baseId).length() >= static_cast<std::size_t>(minSubLengthForDifficulty)) {
+                    final_solutions.push_back(baseId);
+                }
+            }
+        }
+
+        // --- Fallback: Ensure minimum grid words by promoting bonus words ---
+        const std::size_t minGridTarget = static_cast<std::size_t>(std::min(MIN_DESIRED_GRID_WORDS, maxSolutionsForDifficulty));
+        if (final_solutions.size() < minGridTarget) {
+            const std::size_t existingCount = final_solutions.size(); // Fewer than minGridTarget
+            auto isExisting = [&](WordId id) {
+                for (std::size_t i = 0; i < existingCount; ++i) {
+                    if (text(final_solutions[i]) == text(id)) return true;
+                }
+                return false;
+            };
+
+            std::vector<WordId> fallbackCandidates;
+            fallbackCandidates.reserve(puzzle.allPotentialSolutions.size());
+            for (WordId id : puzzle.allPotentialSolutions) {
+                if (text(id).length() < static_cast<std::size_t>(minSubLengthForDifficulty)) {
+                    continue;
+                }
+                if (isExisting(id)) {
+                    continue;
+                }
+                fallbackCandidates.push_back(id);
+            }
+
+            std::sort(fallbackCandidates.begin(), fallbackCandidates.end(), gridOrder);
+
+            for (WordId id : fallbackCandidates) {
+                final_solutions.push_back(id);
+                if (final_solutions.size() >= minGridTarget) {
+                    break;
+                }
+            }
+        }
+
+    }
+    else { // Handle puzzle.base == "ERROR"
+        puzzle.allPotentialSolutions.clear(); final_solutions.clear();
+    }
+
+    // Final lists for game state
+    puzzle.solutions = final_solutions; // UNIQUE list
+    puzzle.sorted = Words::sortForGrid(puzzle.solutions, m_wordList);
+
+    // --- Crossword mode: arrange words into a crossword layout ---
+    if (request.mode == GameMode::Crossword && !puzzle.sorted.empty()) {
+        CrosswordResult cwResult = generateCrossword(CrosswordWords(puzzle.sorted, m_wordList), deriveSeed(request.seed, CROSSWORD_STREAM), m_crosswordOptions);
+        puzzle.crosswordPlacements = std::move(cwResult.placements);
+        puzzle.crosswordGridRows = cwResult.gridRows;
+        puzzle.crosswordGridCols = cwResult.gridCols;
+        puzzle.crosswordTrials = cwResult.trialsUsed;
+        puzzle.crosswordInputWords = puzzle.sorted;
+
+        // Replace sorted/solutions with only the words that were placed
+        std::vector<WordId> placedIds;
+        placedIds.reserve(cwResult.placedIndices.size());
+        for (std::size_t index : cwResult.placedIndices) placedIds.push_back(puzzle.crosswordInputWords[index]);
+        puzzle.sorted = placedIds;
+        puzzle.solutions = std::move(placedIds);
+    }
+
+    return puzzle;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef PUZZLEGENERATOR_H
+#define PUZZLEGENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Crossword.h"
+#include "PuzzleRules.h"
+#include "RootPool.h"
+#include "WordInfo.h"
+
+namespace Words { class SubWordIndex; }
+
+//--------------------------------------------------------------------
+//  Puzzle generation (no SFML)
+//--------------------------------------------------------------------
+// Base-word selection, sub-word filtering / truncation, base-word insertion and
+// crossword placement, used by Game::m_rebuild and by the headless tools.
+
+// Base-word criteria for one puzzle of a session
+struct PuzzleCriteria {
+    std::vector<int> allowedLengths;
+    std::vector<int> allowedRarities;
+};
+
+// Everything one puzzle depends on besides the word data
+struct PuzzleRequest {
+    std::uint64_t seed = 0;     // Determines every random choice (see Seed.h)
+    GameMode mode = GameMode::Casual;
+    DifficultyLevel difficulty = DifficultyLevel::None;
+    int puzzleIndex = 0;        // Position in the session (the last Hard puzzle is rarer)
+    int puzzlesPerSession = 0;
+    std::vector<bool> usedAnagramClasses; // Indexed by WordInfo::anagramClass; those bases are skipped
+};
+
+// Word lists hold ids into the generator's word list (see WordId)
+struct Puzzle {
+    std::uint32_t rootIndex = Words::RootPool::NO_ROOT; // Into the root pool; NO_ROOT for a forced repeat
+    std::string baseWord;                                // Chosen root word
+    std::string base;                                    // Its letters, scrambled ("ERROR" when none)
+    std::vector<WordId> allPotentialSolutions;           // Every sub-word (grid + bonus)
+    std::vector<WordId> solutions;                       // Grid words
+    std::vector<WordId> sorted;                          // Grid words in display order
+    std::vector<CrosswordPlacement> crosswordPlacements; // Crossword mode only, parallel to 'sorted'
+    int crosswordGridRows = 0;
+    int crosswordGridCols = 0;
+    int crosswordTrials = 0;                             // Layout trials searched (see CrosswordOptions)
+    std::vector<WordId> crosswordInputWords;             // Words offered to the layout (its CrosswordCache key)
+};
+
+class PuzzleGenerator {
+public:
+    // The generator keeps references; the word data must outlive it and stay unchanged
+    // while generate() may run. 'subWordIndex' and 'rootPool' are built from 'wordList'.
+    PuzzleGenerator(const std::vector<WordInfo>& wordList, const Words::SubWordIndex& subWordIndex,
+        const Words::RootPool& rootPool);
+
+    // Thread-safe and deterministic: the same request (and word data) always gives
+    // the same puzzle. A used anagram class only matters if the draw lands on it.
+    Puzzle generate(const PuzzleRequest& request) const;
+
+    static PuzzleCriteria criteriaFor(const PuzzleRequest& request);
+
+    // Step-by-step DEBUG output on std::cout (errors always go to std::cerr)
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+
+    // Search budget for crossword layouts. Not part of the puzzle key: a time budget
+    // can cut the search short, so a replay only matches if it stopped for another reason.
+    void setCrosswordOptions(const CrosswordOptions& options) { m_crosswordOptions = options; }
+    const CrosswordOptions& crosswordOptions() const { return m_crosswordOptions; }
+
+    const Words::RootPool& rootPool() const { return m_rootPool; }
+    const std::vector<WordInfo>& wordList() const { return m_wordList; }
+
+private:
+    std::ostream& m_log() const;
+    std::vector<WordId> m_findSubWords(const std::string& base) const;
+
+    const std::vector<WordInfo>& m_wordList;
+    const Words::SubWordIndex& m_subWordIndex;
+    const Words::RootPool& m_rootPool;
+    bool m_verbose = false;
+    CrosswordOptions m_crosswordOptions;
+};
+
+// Short text form of a request for logs and replays:
+// "seed:difficulty:mode[:index/count][:used=class,class,...]", e.g.
+// "8123476234:hard:crossword:4/5:used=812,4410". The used anagram classes are
+// listed because skipping a used root changes later draws; class ids depend on
+// the word list, so a key replays against the same list.
+std::string puzzleKey(const PuzzleRequest& request);
+// Parses a puzzleKey() string into 'request', including its used anagram classes
+// (other fields untouched). False when malformed.
+bool parsePuzzleKey(const std::string& key, PuzzleRequest& request);
+
+#endif // PUZZLEGENERATOR_H
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef PUZZLERULES_H
+#define PUZZLERULES_H
+
+//--------------------------------------------------------------------
+//  Puzzle rules shared by the game and the command-line tools
+//--------------------------------------------------------------------
+// Kept free of SFML so tools/ can include it; Constants.h pulls it in for the game.
+
+enum class GameMode { Casual, Crossword };
+
+enum class DifficultyLevel {
+    None, // Default state or for modes without difficulty
+    Easy,
+    Medium,
+    Hard
+};
+
+const int MIN_WORD_LENGTH = 3;
+const int HARD_MIN_WORD_LENGTH = 4;
+
+const int EASY_MAX_SOLUTIONS = 7;
+const int MEDIUM_MAX_SOLUTIONS = 12;
+const int HARD_MAX_SOLUTIONS = 15;
+const int MIN_DESIRED_GRID_WORDS = 5;
+
+const int CROSSWORD_EASY_MAX_SOLUTIONS = 10;
+const int CROSSWORD_MEDIUM_MAX_SOLUTIONS = 15;
+const int CROSSWORD_HARD_MAX_SOLUTIONS = 20;
+
+// Base (root) words are picked from this length range
+const int MIN_ROOT_WORD_LENGTH = 4;
+const int MAX_ROOT_WORD_LENGTH = 7;
+
+// Rarity window a sub-word must fall in to be used as a grid word, per difficulty.
+// Game::m_rebuild filters with these; the offline metrics count with them.
+const int EASY_SUB_WORD_MIN_RARITY = 1;
+const int EASY_SUB_WORD_MAX_RARITY = 2;
+const int MEDIUM_SUB_WORD_MIN_RARITY = 1;
+const int MEDIUM_SUB_WORD_MAX_RARITY = 3;
+const int HARD_SUB_WORD_MIN_RARITY = 2;
+const int HARD_SUB_WORD_MAX_RARITY = 4;
+
+#endif // PUZZLERULES_H
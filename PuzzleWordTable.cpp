@@ -0,0 +1,97 @@
+#include "PuzzleWordTable.h"
+
+#include <algorithm>
+
+namespace {
+
+    std::uint64_t hashText(std::string_view text) {
+        std::uint64_t hash = 14695981039346656037ull; // FNV-1a
+        for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ull; }
+        return hash;
+    }
+
+} // namespace
+
+
+void PuzzleWordTable::build(const std::vector<WordId>& grid, const std::vector<WordId>& potential,
+    const std::vector<WordInfo>& wordList) {
+    clear();
+    m_wordList = &wordList;
+
+    // At most half full, so probe runs stay short
+    std::size_t capacity = 16;
+    while (capacity < 2 * (grid.size() + potential.size())) capacity *= 2;
+    m_slots.assign(capacity, NO_ENTRY);
+
+    m_entries.reserve(grid.size() + potential.size());
+
+    for (std::size_t w = 0; w < grid.size(); ++w) m_insert(grid[w], Kind::Grid, w);
+    m_gridCount = m_entries.size();
+    for (std::size_t b = 0; b < potential.size(); ++b) {
+        if (find(wordList[potential[b]].text) == NO_ENTRY) m_insert(potential[b], Kind::Bonus, b);
+    }
+    m_found.assign((m_entries.size() + 63) / 64, 0);
+}
+
+
+void PuzzleWordTable::clear() {
+    m_entries.clear();
+    m_slots.clear();
+    m_gridCount = 0;
+    m_found.clear();
+    m_foundGrid = 0;
+    m_foundBonus = 0;
+}
+
+
+std::uint32_t PuzzleWordTable::find(std::string_view text) const {
+    if (m_slots.empty()) return NO_ENTRY;
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t slot = hashText(text) & mask;; slot = (slot + 1) & mask) {
+        const std::uint32_t id = m_slots[slot];
+        if (id == NO_ENTRY) return NO_ENTRY;
+        if (this->text(id) == text) return id;
+    }
+}
+
+
+bool PuzzleWordTable::isGrid(std::string_view text) const {
+    const std::uint32_t id = find(text);
+    return id != NO_ENTRY && m_entries[id].kind == Kind::Grid;
+}
+
+
+bool PuzzleWordTable::markFound(std::uint32_t id) {
+    if (id == NO_ENTRY || isFound(id)) return false;
+    m_found[id >> 6] |= std::uint64_t(1) << (id & 63);
+    if (m_entries[id].kind == Kind::Grid) m_foundGrid++;
+    else m_foundBonus++;
+    return true;
+}
+
+
+void PuzzleWordTable::clearFound() {
+    std::fill(m_found.begin(), m_found.end(), 0);
+    m_foundGrid = 0;
+    m_foundBonus = 0;
+}
+
+
+// Grid words are added even when their text repeats, so entry ids stay equal
+// to grid positions; the hash then resolves the text to the first of them.
+std::uint32_t PuzzleWordTable::m_insert(WordId word, Kind kind, std::size_t index) {
+    const std::uint32_t id = static_cast<std::uint32_t>(m_entries.size());
+    Entry entry;
+    entry.word = word;
+    entry.index = static_cast<std::uint32_t>(index);
+    entry.kind = kind;
+    m_entries.push_back(entry);
+
+    const std::string_view text = (*m_wordList)[word].text;
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t slot = hashText(text) & mask;; slot = (slot + 1) & mask) {
+        if (m_slots[slot] == NO_ENTRY) { m_slots[slot] = id; break; }
+        if (this->text(m_slots[slot]) == text) break; // Repeated grid text
+    }
+    return id;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef PUZZLEWORDTABLE_H
+#define PUZZLEWORDTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Per-puzzle word table
+//--------------------------------------------------------------------
+// Every distinct word of a puzzle (exact text) with whether it is a grid or a
+// bonus word, behind an open-addressing hash, plus found state as bitsets.
+// Grid words come first, so the entry id of grid word w is w; lookups,
+// "is this a grid word", found checks and completion counts are all O(1)
+// instead of scans over the solution lists and string sets.
+class PuzzleWordTable {
+public:
+    static constexpr std::uint32_t NO_ENTRY = 0xFFFFFFFFu;
+
+    enum class Kind : std::uint8_t { Grid, Bonus };
+
+    struct Entry {
+        WordId word = NO_WORD_ID; // Into the word list given to build()
+        std::uint32_t index = 0; // Into the grid list, or first position in the potential-solution list
+        Kind kind = Kind::Grid;
+    };
+
+    // 'grid' in grid order (entry id == index); 'potential' words that are not
+    // grid words become bonus entries, duplicates keep their first position.
+    // Ids index 'wordList', which must outlive the table unchanged.
+    void build(const std::vector<WordId>& grid, const std::vector<WordId>& potential,
+        const std::vector<WordInfo>& wordList);
+    void clear();
+
+    std::uint32_t find(std::string_view text) const;
+    bool isGrid(std::string_view text) const;
+
+    std::size_t size() const { return m_entries.size(); }
+    std::size_t gridCount() const { return m_gridCount; }
+    std::size_t bonusCount() const { return m_entries.size() - m_gridCount; }
+    const Entry& entry(std::uint32_t id) const { return m_entries[id]; }
+    std::string_view text(std::uint32_t id) const { return (*m_wordList)[m_entries[id].word].text; }
+
+    // --- Found state (cleared by build) ---
+    bool isFound(std::uint32_t id) const { return id != NO_ENTRY && (m_found[id >> 6] >> (id & 63) & 1u) != 0; }
+    bool isGridFound(std::size_t gridIndex) const { return isFound(static_cast<std::uint32_t>(gridIndex)); }
+    // Returns false when the entry was already found
+    bool markFound(std::uint32_t id);
+    void clearFound();
+    std::size_t foundGridCount() const { return m_foundGrid; }
+    std::size_t foundBonusCount() const { return m_foundBonus; }
+    bool allGridFound() const { return m_foundGrid == m_gridCount; }
+
+private:
+    std::uint32_t m_insert(WordId word, Kind kind, std::size_t index);
+
+    const std::vector<WordInfo>* m_wordList = nullptr;
+    std::vector<Entry> m_entries;
+    std::vector<std::uint32_t> m_slots; // Entry ids, NO_ENTRY when empty; size is a power of two
+    std::size_t m_gridCount = 0;
+
+    std::vector<std::uint64_t> m_found;
+    std::size_t m_foundGrid = 0;
+    std::size_t m_foundBonus = 0;
+};
+
+#endif // PUZZLEWORDTABLE_H
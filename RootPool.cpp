@@ -0,0 +1,67 @@
+#include "RootPool.h"
+
+namespace Words {
+
+    namespace {
+        // Valid sub-word count a root is ranked by for a difficulty (as m_rebuild always did)
+        int validCountFor(const WordInfo& root, DifficultyLevel difficulty) {
+            switch (difficulty) {
+            case DifficultyLevel::Easy:   return root.easyValidCount;
+            case DifficultyLevel::Medium: return root.mediumValidCount;
+            case DifficultyLevel::Hard:   return root.hardValidCount;
+            default:                      return root.countGE4;
+            }
+        }
+    }
+
+
+    void RootPool::build(const std::vector<WordInfo>& wordList) {
+        m_wordList = &wordList;
+        m_roots.clear();
+        for (auto& perDifficulty : m_buckets)
+            for (auto& perTier : perDifficulty)
+                for (auto& perLength : perTier)
+                    for (auto& bucket : perLength) bucket.clear();
+
+        // Grouped by length like the old m_roots (4, 5, 6, 7), list order within a length
+        for (int len = MIN_ROOT_WORD_LENGTH; len <= MAX_ROOT_WORD_LENGTH; ++len) {
+            for (std::size_t id = 0; id < wordList.size(); ++id) {
+                if (wordList[id].text.length() == static_cast<std::size_t>(len)) m_roots.push_back(static_cast<WordId>(id));
+            }
+        }
+
+        for (std::uint32_t i = 0; i < m_roots.size(); ++i) {
+            const WordInfo& root = this->root(i);
+            if (root.rarity < 0 || root.rarity > MAX_RARITY) continue; // Only reachable through drawAny()
+            const int lengthSlot = static_cast<int>(root.text.length()) - MIN_ROOT_WORD_LENGTH;
+            const int raritySlot = root.rarity;
+            for (int d = 0; d < DIFFICULTY_COUNT; ++d) {
+                const bool ideal = validCountFor(root, static_cast<DifficultyLevel>(d)) >= MIN_DESIRED_GRID_WORDS;
+                m_buckets[d][ideal ? 0 : 1][lengthSlot][raritySlot].push_back(i);
+            }
+        }
+    }
+
+
+    const RootPool::Bucket* RootPool::m_bucket(DifficultyLevel difficulty, Tier tier, int length, int rarity) const {
+        const int d = static_cast<int>(difficulty);
+        const int lengthSlot = length - MIN_ROOT_WORD_LENGTH;
+        if (d < 0 || d >= DIFFICULTY_COUNT || lengthSlot < 0 || lengthSlot >= LENGTH_COUNT || rarity < 0 || rarity > MAX_RARITY) {
+            return nullptr;
+        }
+        return &m_buckets[d][tier == Tier::Ideal ? 0 : 1][lengthSlot][rarity];
+    }
+
+
+    std::size_t RootPool::count(DifficultyLevel difficulty, Tier tier,
+        const std::vector<int>& lengths, const std::vector<int>& rarities) const {
+        std::size_t total = 0;
+        for (int length : lengths) {
+            for (int rarity : rarities) {
+                if (const Bucket* bucket = m_bucket(difficulty, tier, length, rarity)) total += bucket->size();
+            }
+        }
+        return total;
+    }
+
+} // namespace Words
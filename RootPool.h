@@ -0,0 +1,134 @@
+#pragma once
+#ifndef ROOTPOOL_H
+#define ROOTPOOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "PuzzleRules.h"
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Root (base) word pool
+//--------------------------------------------------------------------
+// Root-length words bucketed once at load by (length, rarity). Every bucket is
+// split per difficulty into "ideal" roots (enough valid sub-words, see WordInfo
+// metrics) and "fallback" roots, so picking a base word is a random draw over
+// the matching buckets instead of a scan of the whole list.
+namespace Words {
+
+    class RootPool {
+    public:
+        static constexpr int MAX_RARITY = 4; // Roots with rarities outside 0..MAX_RARITY are only in drawAny()
+        static constexpr std::uint32_t NO_ROOT = 0xFFFFFFFFu;
+
+        enum class Tier { Ideal, Fallback };
+
+        // Keeps a pointer to 'wordList', which must outlive the pool unchanged
+        void build(const std::vector<WordInfo>& wordList);
+        bool empty() const { return m_roots.empty(); }
+        std::size_t size() const { return m_roots.size(); }
+        WordId rootId(std::uint32_t index) const { return m_roots[index]; }
+        const WordInfo& root(std::uint32_t index) const { return (*m_wordList)[m_roots[index]]; }
+
+        // Number of roots in 'tier' over every (length, rarity) combination given
+        std::size_t count(DifficultyLevel difficulty, Tier tier,
+            const std::vector<int>& lengths, const std::vector<int>& rarities) const;
+
+        // Uniformly picks a root in 'tier' over the given lengths x rarities for which
+        // isUsed(root) is false. Returns NO_ROOT when every such root is used.
+        // A few random draws are tried first; only a mostly-used pool is scanned.
+        template <typename URBG, typename IsUsed>
+        std::uint32_t draw(DifficultyLevel difficulty, Tier tier, const std::vector<int>& lengths,
+            const std::vector<int>& rarities, URBG& rng, IsUsed isUsed) const;
+
+        // Same as draw() over every root regardless of length, rarity and tier
+        template <typename URBG, typename IsUsed>
+        std::uint32_t drawAny(URBG& rng, IsUsed isUsed) const;
+
+    private:
+        static constexpr int LENGTH_COUNT = MAX_ROOT_WORD_LENGTH - MIN_ROOT_WORD_LENGTH + 1;
+        static constexpr int RARITY_COUNT = MAX_RARITY + 1;
+        static constexpr int DIFFICULTY_COUNT = 4; // DifficultyLevel::None..Hard
+        static constexpr int DRAW_ATTEMPTS = 32;
+
+        using Bucket = std::vector<std::uint32_t>;
+
+        const Bucket* m_bucket(DifficultyLevel difficulty, Tier tier, int length, int rarity) const;
+        template <typename URBG, typename IsUsed>
+        std::uint32_t m_drawFrom(const std::vector<const Bucket*>& buckets, std::size_t total, URBG& rng, IsUsed& isUsed) const;
+
+        const std::vector<WordInfo>* m_wordList = nullptr;
+        std::vector<WordId> m_roots;
+        // [difficulty][tier][length - MIN_ROOT_WORD_LENGTH][rarity] -> indices into m_roots
+        std::array<std::array<std::array<std::array<Bucket, RARITY_COUNT>, LENGTH_COUNT>, 2>, DIFFICULTY_COUNT> m_buckets;
+    };
+
+
+    template <typename URBG, typename IsUsed>
+    std::uint32_t RootPool::draw(DifficultyLevel difficulty, Tier tier, const std::vector<int>& lengths,
+        const std::vector<int>& rarities, URBG& rng, IsUsed isUsed) const {
+        std::vector<const Bucket*> buckets;
+        std::size_t total = 0;
+        for (int length : lengths) {
+            for (int rarity : rarities) {
+                const Bucket* bucket = m_bucket(difficulty, tier, length, rarity);
+                if (bucket && !bucket->empty()) {
+                    buckets.push_back(bucket);
+                    total += bucket->size();
+                }
+            }
+        }
+        return m_drawFrom(buckets, total, rng, isUsed);
+    }
+
+
+    template <typename URBG, typename IsUsed>
+    std::uint32_t RootPool::drawAny(URBG& rng, IsUsed isUsed) const {
+        if (m_roots.empty()) return NO_ROOT;
+        for (int attempt = 0; attempt < DRAW_ATTEMPTS; ++attempt) {
+            std::uint32_t candidate = std::uniform_int_distribution<std::uint32_t>(0, static_cast<std::uint32_t>(m_roots.size() - 1))(rng);
+            if (!isUsed(root(candidate))) return candidate;
+        }
+        std::vector<std::uint32_t> unused;
+        for (std::uint32_t i = 0; i < m_roots.size(); ++i) {
+            if (!isUsed(root(i))) unused.push_back(i);
+        }
+        if (unused.empty()) return NO_ROOT;
+        return unused[std::uniform_int_distribution<std::size_t>(0, unused.size() - 1)(rng)];
+    }
+
+
+    template <typename URBG, typename IsUsed>
+    std::uint32_t RootPool::m_drawFrom(const std::vector<const Bucket*>& buckets, std::size_t total, URBG& rng, IsUsed& isUsed) const {
+        if (total == 0) return NO_ROOT;
+
+        // Rejection sampling: uniform over the union, retried while the pick is used
+        for (int attempt = 0; attempt < DRAW_ATTEMPTS; ++attempt) {
+            std::size_t pick = std::uniform_int_distribution<std::size_t>(0, total - 1)(rng);
+            for (const Bucket* bucket : buckets) {
+                if (pick < bucket->size()) {
+                    std::uint32_t candidate = (*bucket)[pick];
+                    if (!isUsed(root(candidate))) return candidate;
+                    break;
+                }
+                pick -= bucket->size();
+            }
+        }
+
+        // Mostly used: collect what is left and pick from it
+        std::vector<std::uint32_t> unused;
+        for (const Bucket* bucket : buckets) {
+            for (std::uint32_t candidate : *bucket) {
+                if (!isUsed(root(candidate))) unused.push_back(candidate);
+            }
+        }
+        if (unused.empty()) return NO_ROOT;
+        return unused[std::uniform_int_distribution<std::size_t>(0, unused.size() - 1)(rng)];
+    }
+
+} // namespace Words
+
+#endif // ROOTPOOL_H
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef SEED_H
+#define SEED_H
+
+#include <cstdint>
+#include <random>
+
+//--------------------------------------------------------------------
+//  Reproducible seeding for puzzle generation
+//--------------------------------------------------------------------
+// One 64-bit seed determines a puzzle. Each stage (base draw, letter scramble,
+// crossword trials, ...) gets its own stream derived from it, so a change in how
+// many numbers one stage draws does not shift the others.
+
+// splitmix64 finalizer: neighbouring inputs give unrelated outputs
+inline std::uint64_t mixSeed(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline std::uint64_t deriveSeed(std::uint64_t seed, std::uint64_t stream) {
+    return mixSeed(seed ^ mixSeed(stream));
+}
+
+// mt19937 for a 64-bit seed. Folded to the engine's 32-bit seed rather than
+// going through std::seed_seq, which costs about four times as much; that matters
+// once every crossword trial gets its own stream. The engine is portable, but the
+// std distributions and std::shuffle are library-specific: a seed reproduces a
+// puzzle for builds using the same standard library.
+inline std::mt19937 seededRng(std::uint64_t seed) {
+    const std::uint64_t mixed = mixSeed(seed);
+    return std::mt19937(static_cast<std::uint32_t>(mixed ^ (mixed >> 32)));
+}
+
+#endif // SEED_H
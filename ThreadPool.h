@@ -0,0 +1,106 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//--------------------------------------------------------------------
+//  ThreadPool - fixed set of worker threads for CPU-bound batch work
+//--------------------------------------------------------------------
+// Used by the word-list loader, the offline tools and puzzle generation.
+// No SFML dependency so the command-line targets can share it.
+class ThreadPool {
+public:
+    // threadCount == 0 uses std::thread::hardware_concurrency() (at least 1)
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+    // Process-wide pool sized to the machine, created on first use
+    static ThreadPool& shared();
+
+    // Queues 'task' and returns a future for its result
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+        std::future<R> result = packaged->get_future();
+        m_enqueue([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    // Calls fn(i) for every i in [0, count) and returns once all calls finished.
+    // The calling thread takes part, so this is safe to use from inside a pool task.
+    // The first exception thrown by fn is rethrown here.
+    template <typename Fn>
+    void parallelFor(std::size_t count, Fn&& fn) {
+        if (count == 0) return;
+        if (count == 1 || m_workers.empty()) {
+            for (std::size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        struct State {
+            std::atomic<std::size_t> next{ 0 };
+            std::atomic<std::size_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<State>();
+        const std::size_t total = count;
+        auto* body = &fn; // Only dereferenced while items remain, i.e. before this call returns
+
+        auto drain = [state, total, body]() {
+            std::size_t i;
+            while ((i = state->next.fetch_add(1)) < total) {
+                try {
+                    (*body)(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                }
+                if (state->done.fetch_add(1) + 1 == total) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        const std::size_t helpers = std::min<std::size_t>(m_workers.size(), total - 1);
+        for (std::size_t h = 0; h < helpers; ++h) m_enqueue(drain);
+        drain();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->done.load() == total; });
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
+private:
+    void m_enqueue(std::function<void()> job);
+    void m_workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+};
+
+#endif // THREADPOOL_H
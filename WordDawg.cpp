@@ -0,0 +1,189 @@
+#include "WordDawg.h"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include <utility>
+
+namespace Words {
+
+    namespace {
+
+        char foldLetter(char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+
+        // Trie node while building; merged nodes are left unreferenced
+        struct BuildNode {
+            bool terminal = false;
+            std::vector<std::pair<char, std::uint32_t>> edges; // Appended in letter order
+        };
+
+        // Identifies a node by its finality and outgoing edges; only valid once
+        // every child is itself registered (equal subgraphs then have equal ids)
+        std::string signature(const BuildNode& node) {
+            std::string key;
+            key.reserve(1 + node.edges.size() * 5);
+            key.push_back(node.terminal ? '1' : '0');
+            for (const auto& edge : node.edges) {
+                key.push_back(edge.first);
+                key.append(reinterpret_cast<const char*>(&edge.second), sizeof(edge.second));
+            }
+            return key;
+        }
+
+    } // namespace
+
+
+    // Incremental construction over sorted input (Daciuk et al.): the path of the
+    // previous word past the common prefix can no longer change, so its nodes are
+    // merged with equal registered nodes before the next word branches off.
+    void WordDawg::build(std::vector<std::string> words) {
+        clear();
+        for (auto& word : words) {
+            for (char& c : word) c = foldLetter(c);
+        }
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+        if (!words.empty() && words.front().empty()) words.erase(words.begin());
+
+        std::vector<BuildNode> nodes(1);
+        std::unordered_map<std::string, std::uint32_t> registry;
+        struct Pending { std::uint32_t parent; std::uint32_t child; };
+        std::vector<Pending> unchecked; // Path of the previous word, root first
+
+        auto minimize = [&](std::size_t keep) {
+            while (unchecked.size() > keep) {
+                const Pending pending = unchecked.back();
+                unchecked.pop_back();
+                auto inserted = registry.emplace(signature(nodes[pending.child]), pending.child);
+                if (!inserted.second) nodes[pending.parent].edges.back().second = inserted.first->second;
+            }
+        };
+
+        const std::string* previous = nullptr;
+        for (const std::string& word : words) {
+            std::size_t common = 0;
+            if (previous) {
+                const std::size_t limit = std::min(previous->size(), word.size());
+                while (common < limit && (*previous)[common] == word[common]) ++common;
+            }
+            minimize(common);
+
+            std::uint32_t node = unchecked.empty() ? 0 : unchecked.back().child;
+            for (std::size_t i = common; i < word.size(); ++i) {
+                const std::uint32_t child = static_cast<std::uint32_t>(nodes.size());
+                nodes.emplace_back();
+                nodes[node].edges.emplace_back(word[i], child);
+                unchecked.push_back({ node, child });
+                node = child;
+            }
+            nodes[node].terminal = true;
+            previous = &word;
+        }
+        minimize(0);
+
+        // Flatten the reachable nodes (root first) and count the words below each
+        std::vector<std::uint32_t> remap(nodes.size(), NO_NODE);
+        std::vector<std::uint32_t> order{ 0 };
+        remap[0] = 0;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (const auto& edge : nodes[order[i]].edges) {
+                if (remap[edge.second] != NO_NODE) continue;
+                remap[edge.second] = static_cast<std::uint32_t>(order.size());
+                order.push_back(edge.second);
+            }
+        }
+
+        std::vector<std::uint32_t> wordsBelow(order.size(), 0);
+        std::vector<std::pair<std::uint32_t, bool>> stack{ { 0u, false } }; // (old id, children done)
+        std::vector<bool> counted(order.size(), false);
+        while (!stack.empty()) {
+            const auto top = stack.back();
+            stack.pop_back();
+            const std::uint32_t id = remap[top.first];
+            if (counted[id]) continue;
+            const BuildNode& node = nodes[top.first];
+            if (!top.second) {
+                stack.push_back({ top.first, true });
+                for (const auto& edge : node.edges) {
+                    if (!counted[remap[edge.second]]) stack.push_back({ edge.second, false });
+                }
+                continue;
+            }
+            std::uint32_t total = node.terminal ? 1 : 0;
+            for (const auto& edge : node.edges) total += wordsBelow[remap[edge.second]];
+            wordsBelow[id] = total;
+            counted[id] = true;
+        }
+
+        m_nodes.resize(order.size());
+        std::size_t edgeTotal = 0;
+        for (std::uint32_t old : order) edgeTotal += nodes[old].edges.size();
+        m_edges.reserve(edgeTotal);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const BuildNode& node = nodes[order[i]];
+            m_nodes[i].firstEdge = static_cast<std::uint32_t>(m_edges.size());
+            m_nodes[i].edgeCount = static_cast<std::uint8_t>(node.edges.size());
+            m_nodes[i].terminal = node.terminal;
+            std::uint32_t skip = node.terminal ? 1 : 0; // The prefix itself sorts before its extensions
+            for (const auto& edge : node.edges) {
+                Edge flat;
+                flat.target = remap[edge.second];
+                flat.skip = skip;
+                flat.letter = edge.first;
+                m_edges.push_back(flat);
+                skip += wordsBelow[flat.target];
+            }
+        }
+        m_wordCount = words.size();
+    }
+
+
+    void WordDawg::build(const std::vector<WordInfo>& words) {
+        std::vector<std::string> texts;
+        texts.reserve(words.size());
+        for (const WordInfo& word : words) texts.push_back(word.text);
+        build(std::move(texts));
+    }
+
+
+    void WordDawg::clear() {
+        m_nodes.clear();
+        m_edges.clear();
+        m_wordCount = 0;
+    }
+
+
+    WordDawg::Cursor WordDawg::root() const {
+        Cursor cursor;
+        if (m_wordCount > 0) cursor.node = 0;
+        return cursor;
+    }
+
+
+    WordDawg::Cursor WordDawg::step(Cursor cursor, char letter) const {
+        if (!cursor.alive()) return cursor;
+        const char folded = foldLetter(letter);
+        const Node& node = m_nodes[cursor.node];
+        const Edge* edge = m_edges.data() + node.firstEdge;
+        for (const Edge* end = edge + node.edgeCount; edge != end; ++edge) {
+            if (edge->letter != folded) continue;
+            cursor.node = edge->target;
+            cursor.ordinal += edge->skip;
+            return cursor;
+        }
+        return Cursor{};
+    }
+
+
+    std::uint32_t WordDawg::find(std::string_view word) const {
+        Cursor cursor = root();
+        for (char c : word) {
+            cursor = step(cursor, c);
+            if (!cursor.alive()) return NO_WORD;
+        }
+        return ordinal(cursor);
+    }
+
+} // namespace Words
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef WORDDAWG_H
+#define WORDDAWG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Word DAWG (minimal acyclic word automaton)
+//--------------------------------------------------------------------
+// All words of a list in one letter graph with shared prefixes and suffixes,
+// case-folded to lowercase. Membership is a walk of one edge per letter; a
+// Cursor keeps the walk between letters so a guess can be checked while it is
+// typed. Every word also gets its ordinal (position in sorted order of the
+// distinct words), accumulated along the walk, which callers use to key
+// per-puzzle data without touching strings.
+namespace Words {
+
+    class WordDawg {
+    public:
+        static constexpr std::uint32_t NO_WORD = 0xFFFFFFFFu;
+
+        struct Cursor {
+            std::uint32_t node = NO_NODE;
+            std::uint32_t ordinal = 0; // Words ordered before the current prefix
+            bool alive() const { return node != NO_NODE; } // Some word starts with the letters walked so far
+        };
+
+        void build(std::vector<std::string> words);
+        void build(const std::vector<WordInfo>& words);
+        void clear();
+
+        Cursor root() const;
+        // Follows 'letter' (any case); a dead cursor stays dead
+        Cursor step(Cursor cursor, char letter) const;
+        bool isWord(Cursor cursor) const { return cursor.alive() && m_nodes[cursor.node].terminal; }
+        // Ordinal of the word walked so far, NO_WORD when it is not a word
+        std::uint32_t ordinal(Cursor cursor) const { return isWord(cursor) ? cursor.ordinal : NO_WORD; }
+
+        std::uint32_t find(std::string_view word) const;
+        bool contains(std::string_view word) const { return find(word) != NO_WORD; }
+
+        std::size_t size() const { return m_wordCount; }
+        bool empty() const { return m_wordCount == 0; }
+        std::size_t nodeCount() const { return m_nodes.size(); }
+        std::size_t edgeCount() const { return m_edges.size(); }
+        std::size_t memoryBytes() const { return m_nodes.capacity() * sizeof(Node) + m_edges.capacity() * sizeof(Edge); }
+
+    private:
+        static constexpr std::uint32_t NO_NODE = 0xFFFFFFFFu;
+
+        struct Node {
+            std::uint32_t firstEdge = 0;
+            std::uint8_t edgeCount = 0;
+            bool terminal = false;
+        };
+        struct Edge {
+            std::uint32_t target = 0;
+            std::uint32_t skip = 0; // Words of the source node ordered before this edge
+            char letter = 0;
+        };
+
+        std::vector<Node> m_nodes; // m_nodes[0] is the root
+        std::vector<Edge> m_edges; // Per node, sorted by letter
+        std::size_t m_wordCount = 0;
+    };
+
+} // namespace Words
+
+#endif // WORDDAWG_H
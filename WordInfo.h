@@ -0,0 +1,52 @@
+#pragma once
+#ifndef WORDINFO_H
+#define WORDINFO_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+//--------------------------------------------------------------------
+//  Word Data Structure
+//--------------------------------------------------------------------
+// Structure to hold word data including rarity and pre-calculated metrics.
+// Part of speech, definition and sentence are not kept here; they are only
+// needed by the solved-word popup and are fetched on demand through
+// Words::WordDetailsStore using detailsId.
+struct WordInfo {
+    static constexpr std::uint32_t NO_DETAILS = 0xFFFFFFFFu;
+    static constexpr std::uint32_t NO_ANAGRAM_CLASS = 0xFFFFFFFFu;
+
+    std::string text = "";
+    int rarity = 0;
+    std::uint32_t detailsId = NO_DETAILS; // Handle into the WordDetailsStore the list was loaded with
+    std::uint32_t anagramClass = NO_ANAGRAM_CLASS; // Same value for words with the same letters (Words::assignAnagramClasses)
+
+    // --- NEW Pre-calculated Metrics ---
+    float avgSubLen = 0.0f;         // Average length of sub-words (>= MIN_SUB_WORD_LEN)
+    int countGE3 = 0;               // Count of sub-words with length >= 3
+    int countGE4 = 0;               // Count of sub-words with length >= 4
+    int countGE5 = 0;               // Count of sub-words with length >= 5
+    int easyValidCount = 0;         // Count valid for Easy difficulty criteria
+    int mediumValidCount = 0;       // Count valid for Medium difficulty criteria
+    int hardValidCount = 0;         // Count valid for Hard difficulty criteria
+
+    // Optional: Constructor for easier initialization if needed
+    WordInfo() = default; // Keep default constructor
+
+    // Example constructor if you want to set everything at once
+    WordInfo(std::string t, int r, std::uint32_t details = NO_DETAILS,
+        float avgSL = 0.0f, int c3 = 0, int c4 = 0, int c5 = 0, int ec = 0, int mc = 0, int hc = 0)
+        : text(std::move(t)), rarity(r), detailsId(details), avgSubLen(avgSL), countGE3(c3), countGE4(c4),
+        countGE5(c5), easyValidCount(ec), mediumValidCount(mc), hardValidCount(hc) {
+    }
+
+};
+
+// A word by its position in the loaded word list. The list is not changed after
+// loading, so puzzle and game state keep ids and read text, rarity and metrics
+// from the list instead of holding WordInfo copies.
+using WordId = std::uint32_t;
+constexpr WordId NO_WORD_ID = 0xFFFFFFFFu;
+
+#endif // WORDINFO_H
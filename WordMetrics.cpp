@@ -0,0 +1,194 @@
+#include "WordMetrics.h"
+#include "PuzzleRules.h"
+#include "ThreadPool.h"
+#include "Words.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Words {
+
+    namespace {
+        bool isRootLength(const std::string& text) {
+            return text.length() >= static_cast<std::size_t>(MIN_ROOT_WORD_LENGTH)
+                && text.length() <= static_cast<std::size_t>(MAX_ROOT_WORD_LENGTH);
+        }
+
+        bool inRarityWindow(int rarity, int minRarity, int maxRarity) {
+            return rarity >= minRarity && rarity <= maxRarity;
+        }
+
+        const std::string FINGERPRINT_PREFIX = "#wordList=";
+        const char* METRICS_HEADER = "word,avgSubLen,countGE3,countGE4,countGE5,easyValidCount,mediumValidCount,hardValidCount";
+
+        // FNV-1a over every "text,rarity" in list order. Only what the metrics depend on,
+        // so edits to definitions or line endings do not invalidate the file.
+        std::string wordListFingerprint(const std::vector<WordInfo>& wordList) {
+            std::uint64_t hash = 1469598103934665603ull;
+            auto mix = [&hash](unsigned char c) { hash ^= c; hash *= 1099511628211ull; };
+            for (const auto& info : wordList) {
+                for (unsigned char c : info.text) mix(c);
+                mix(',');
+                for (char c : std::to_string(info.rarity)) mix(static_cast<unsigned char>(c));
+                mix('\n');
+            }
+            std::ostringstream out;
+            out << std::hex << hash << "-" << std::dec << wordList.size();
+            return out.str();
+        }
+    }
+
+
+    std::string metricsPathFor(const std::string& csvPath) {
+        std::filesystem::path p(csvPath);
+        p.replace_extension(".metrics.csv");
+        return p.string();
+    }
+
+
+    void computeWordMetrics(WordInfo& root, const std::vector<WordInfo>& wordList, const SubWordIndex& index) {
+        std::vector<std::size_t> subIndices;
+        index.findSubWords(root.text, wordList, subIndices);
+
+        // Same de-duplication as m_rebuild: the first entry of each text wins
+        std::unordered_set<std::string> seen;
+        seen.reserve(subIndices.size());
+        int totalLength = 0, counted = 0;
+        int ge3 = 0, ge4 = 0, ge5 = 0, easy = 0, medium = 0, hard = 0;
+
+        for (std::size_t idx : subIndices) {
+            const WordInfo& sub = wordList[idx];
+            const int len = static_cast<int>(sub.text.length());
+            if (len < MIN_WORD_LENGTH || !seen.insert(sub.text).second) continue;
+
+            totalLength += len;
+            counted++;
+            ge3++;
+            if (len >= 4) ge4++;
+            if (len >= 5) ge5++;
+            if (inRarityWindow(sub.rarity, EASY_SUB_WORD_MIN_RARITY, EASY_SUB_WORD_MAX_RARITY)) easy++;
+            if (inRarityWindow(sub.rarity, MEDIUM_SUB_WORD_MIN_RARITY, MEDIUM_SUB_WORD_MAX_RARITY)) medium++;
+            if (len >= HARD_MIN_WORD_LENGTH && inRarityWindow(sub.rarity, HARD_SUB_WORD_MIN_RARITY, HARD_SUB_WORD_MAX_RARITY)) hard++;
+        }
+
+        root.avgSubLen = counted > 0 ? static_cast<float>(totalLength) / static_cast<float>(counted) : 0.0f;
+        root.countGE3 = ge3;
+        root.countGE4 = ge4;
+        root.countGE5 = ge5;
+        root.easyValidCount = easy;
+        root.mediumValidCount = medium;
+        root.hardValidCount = hard;
+    }
+
+
+    std::size_t computeRootMetrics(std::vector<WordInfo>& wordList, const SubWordIndex& index) {
+        std::vector<std::size_t> roots;
+        for (std::size_t i = 0; i < wordList.size(); ++i) {
+            if (isRootLength(wordList[i].text)) roots.push_back(i);
+        }
+
+        // Each root only writes its own entry; the list itself is not resized
+        const std::size_t rootsPerChunk = 256;
+        const std::size_t chunkCount = (roots.size() + rootsPerChunk - 1) / rootsPerChunk;
+        ThreadPool::shared().parallelFor(chunkCount, [&](std::size_t chunkIdx) {
+            const std::size_t begin = chunkIdx * rootsPerChunk;
+            const std::size_t end = std::min(roots.size(), begin + rootsPerChunk);
+            for (std::size_t r = begin; r < end; ++r) {
+                computeWordMetrics(wordList[roots[r]], wordList, index);
+            }
+        });
+        return roots.size();
+    }
+
+
+    bool writeWordMetrics(const std::vector<WordInfo>& wordList, const std::string& metricsPath) {
+        const std::string tmpPath = metricsPath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                std::cerr << "Error: Could not open " << tmpPath << " for writing." << std::endl;
+                return false;
+            }
+            out << FINGERPRINT_PREFIX << wordListFingerprint(wordList) << '\n';
+            out << METRICS_HEADER << '\n';
+            for (const auto& info : wordList) {
+                if (!isRootLength(info.text)) continue;
+                out << info.text << ',' << info.avgSubLen << ',' << info.countGE3 << ',' << info.countGE4 << ',' << info.countGE5
+                    << ',' << info.easyValidCount << ',' << info.mediumValidCount << ',' << info.hardValidCount << '\n';
+            }
+            if (!out) {
+                std::cerr << "Error: Failed writing " << tmpPath << std::endl;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, metricsPath, ec);
+        if (ec) {
+            std::cerr << "Error: Could not replace " << metricsPath << ": " << ec.message() << std::endl;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+
+    std::size_t applyWordMetrics(std::vector<WordInfo>& wordList, const std::string& metricsPath) {
+        std::ifstream file(metricsPath, std::ios::binary);
+        if (!file.is_open()) return 0;
+
+        std::string line;
+        int lineNum = 0;
+        std::getline(file, line); // #wordList=...
+        lineNum++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.compare(0, FINGERPRINT_PREFIX.size(), FINGERPRINT_PREFIX) != 0
+            || line.substr(FINGERPRINT_PREFIX.size()) != wordListFingerprint(wordList)) {
+            std::cerr << "Warning: Word metrics " << metricsPath << " were computed from a different word list; ignoring them. Re-run WordMetrics." << std::endl;
+            return 0;
+        }
+        std::getline(file, line); // Column names
+        lineNum++;
+
+        std::unordered_map<std::string, WordInfo> metrics;
+        while (std::getline(file, line)) {
+            lineNum++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+
+            std::istringstream fields(line);
+            WordInfo m;
+            char c1 = 0, c2 = 0, c3 = 0, c4 = 0, c5 = 0, c6 = 0; // Separators
+            if (!std::getline(fields, m.text, ',')
+                || !(fields >> m.avgSubLen >> c1 >> m.countGE3 >> c2 >> m.countGE4 >> c3 >> m.countGE5
+                    >> c4 >> m.easyValidCount >> c5 >> m.mediumValidCount >> c6 >> m.hardValidCount)) {
+                std::cerr << "Warning: Skipping malformed line " << lineNum << " in " << metricsPath << std::endl;
+                continue;
+            }
+            metrics[m.text] = m;
+        }
+
+        std::size_t updated = 0;
+        for (auto& info : wordList) {
+            auto it = metrics.find(info.text);
+            if (it == metrics.end()) continue;
+            const WordInfo& m = it->second;
+            info.avgSubLen = m.avgSubLen;
+            info.countGE3 = m.countGE3;
+            info.countGE4 = m.countGE4;
+            info.countGE5 = m.countGE5;
+            info.easyValidCount = m.easyValidCount;
+            info.mediumValidCount = m.mediumValidCount;
+            info.hardValidCount = m.hardValidCount;
+            updated++;
+        }
+        return updated;
+    }
+
+} // namespace Words
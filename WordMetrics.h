@@ -0,0 +1,46 @@
+#pragma once
+#ifndef WORDMETRICS_H
+#define WORDMETRICS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "WordInfo.h"
+
+//--------------------------------------------------------------------
+//  Pre-calculated root-word metrics
+//--------------------------------------------------------------------
+// Fills the WordInfo metric fields (avgSubLen, countGE3/4/5, easy/medium/hard
+// ValidCount) that Game::m_rebuild ranks base-word candidates by.
+// They are computed offline by tools/WordMetrics and stored next to the word list
+// in "<list>.metrics.csv":
+//   #wordList=<fingerprint of the texts and rarities the metrics were computed from>
+//   word,avgSubLen,countGE3,countGE4,countGE5,easyValidCount,mediumValidCount,hardValidCount
+//   ...one row per root-length word
+namespace Words {
+
+    class SubWordIndex;
+
+    // "words_processed.csv" -> "words_processed.metrics.csv"
+    std::string metricsPathFor(const std::string& csvPath);
+
+    // Computes the metrics of 'root' from its distinct sub-words in 'wordList'
+    // (the root itself is not counted). 'index' must be built from 'wordList'.
+    void computeWordMetrics(WordInfo& root, const std::vector<WordInfo>& wordList, const SubWordIndex& index);
+
+    // Computes the metrics of every root-length word of 'wordList' in place, in parallel.
+    // Returns the number of words updated.
+    std::size_t computeRootMetrics(std::vector<WordInfo>& wordList, const SubWordIndex& index);
+
+    // Writes the metrics of every root-length word, tagged with a fingerprint of
+    // 'wordList' so a changed list can be detected. Returns false on I/O failure.
+    bool writeWordMetrics(const std::vector<WordInfo>& wordList, const std::string& metricsPath);
+
+    // Copies metrics from 'metricsPath' onto matching words (by text).
+    // Returns the number of words updated; 0 when the file is missing, unreadable,
+    // or was computed from a different word list (a warning is printed).
+    std::size_t applyWordMetrics(std::vector<WordInfo>& wordList, const std::string& metricsPath);
+
+} // namespace Words
+
+#endif // WORDMETRICS_H
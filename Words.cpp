@@ -1,8 +1,11 @@
 #include "Words.h"
-#include "GameData.h" // Ensure WordInfo definition is available
+#include "WordInfo.h" // Ensure WordInfo definition is available
+#include "CompiledDictionary.h"
+#include "ThreadPool.h"
 
 // *** Standard Includes ***
 #include <fstream>      // For std::ifstream
+#include <iterator>     // For std::istreambuf_iterator
 #include <sstream>      // For std::stringstream
 #include <iostream>     // For std::cerr, std::cout
 #include <string>       // For std::string, std::getline, std::stoi, std::stof
@@ -10,7 +13,7 @@
 #include <stdexcept>    // For std::invalid_argument, std::out_of_range
 #include <algorithm>    // For std::sort, std::all_of
 #include <cctype>       // For std::tolower
-#include <map>  
+#include <array>        // For std::array (letter signatures)
 // ***********************************
 
 
@@ -62,6 +65,7 @@ namespace Words {
 
             while (std::getline(in, line)) {
                 lineNum++;
+                if (!line.empty() && line.back() == '\r') line.pop_back(); // Files are read in binary mode
                 if (!out.empty()) out += "\n";
                 out += line;
                 anyRead = true;
@@ -84,66 +88,289 @@ namespace Words {
 
             return anyRead && !out.empty();
         }
+
+        // One CSV record inside an in-memory file buffer
+        struct CsvRecordSpan {
+            std::size_t begin = 0;  // Offset of the record's first character
+            std::size_t end = 0;    // Offset one past its last character (excluding the final newline)
+            int lastLine = 0;       // 1-based physical line the record ends on
+        };
+
+        // Splits a whole file into records using the same rules as readCsvRecord:
+        // a record ends at the first newline reached outside quotes, and "" inside
+        // quotes on the same line is an escaped quote.
+        std::vector<CsvRecordSpan> splitCsvRecords(const std::string& buffer) {
+            std::vector<CsvRecordSpan> records;
+            records.reserve(buffer.size() / 128 + 1);
+
+            const std::size_t size = buffer.size();
+            std::size_t pos = 0;
+            std::size_t recordStart = 0;
+            int lineNum = 0;
+            bool inQuotes = false;
+
+            while (pos < size) {
+                std::size_t lineEnd = buffer.find('\n', pos);
+                if (lineEnd == std::string::npos) lineEnd = size;
+                std::size_t contentEnd = lineEnd;
+                if (contentEnd > pos && buffer[contentEnd - 1] == '\r') --contentEnd;
+                lineNum++;
+
+                for (std::size_t i = pos; i < contentEnd; ++i) {
+                    if (buffer[i] == '"') {
+                        if (inQuotes && i + 1 < contentEnd && buffer[i + 1] == '"') {
+                            ++i;
+                        }
+                        else {
+                            inQuotes = !inQuotes;
+                        }
+                    }
+                }
+
+                if (!inQuotes) {
+                    records.push_back({ recordStart, contentEnd, lineNum });
+                    recordStart = lineEnd + 1;
+                }
+                pos = lineEnd + 1;
+            }
+
+            // Unterminated quote at end of file: keep what was read, like readCsvRecord
+            if (inQuotes && recordStart < size) {
+                std::size_t end = size;
+                if (buffer[end - 1] == '\r') --end;
+                records.push_back({ recordStart, end, lineNum });
+            }
+            return records;
+        }
+
+        // Record text as readCsvRecord would return it (lines joined by '\n', CRs dropped)
+        void recordText(const std::string& buffer, const CsvRecordSpan& span, std::string& out) {
+            out.assign(buffer, span.begin, span.end - span.begin);
+            if (out.find('\r') != std::string::npos) {
+                std::string cleaned;
+                cleaned.reserve(out.size());
+                for (std::size_t i = 0; i < out.size(); ++i) {
+                    if (out[i] == '\r' && i + 1 < out.size() && out[i + 1] == '\n') continue;
+                    cleaned.push_back(out[i]);
+                }
+                out.swap(cleaned);
+            }
+        }
+
+        bool equalsIgnoreCase(const std::string& a, const std::string& b) {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+            }
+            return true;
+        }
+
+        // Exact per-byte check used for the rare words with characters outside a-z
+        bool fitsByteCounts(const std::string& sub, const std::string& base) {
+            int counts[256] = {};
+            for (char c : base) counts[std::tolower(static_cast<unsigned char>(c))]++;
+            for (char c : sub) {
+                if (--counts[std::tolower(static_cast<unsigned char>(c))] < 0) return false;
+            }
+            return true;
+        }
     }
 
-    // Function to load the pre-processed word list
-    std::vector<WordInfo> loadProcessedWordList(const std::string& filename) {
+    // Function to load the pre-processed word list.
+    // The file is read into one buffer, split into records (honouring newlines inside
+    // quoted fields exactly like readCsvRecord), and the records are parsed in chunks on
+    // the shared thread pool. Chunk results and warnings are merged in file order.
+    std::vector<WordInfo> loadProcessedWordList(const std::string& filename, WordDetailsStore* details) {
         std::vector<WordInfo> wordList;
-        std::ifstream file(filename);
-        std::string line;
+        std::ifstream file(filename, std::ios::binary); // Binary so record offsets can be seeked back to
 
         if (!file.is_open()) {
             std::cerr << "Error: Could not open processed word list file: " << filename << std::endl;
             return wordList; // Return empty list on failure
         }
+        std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        if (details) details->attachCsv(filename);
 
-        int lineNum = 0; // For error reporting (physical lines)
-        // Optional: Skip header row if your CSV has one
-        readCsvRecord(file, line, lineNum);
+        std::vector<CsvRecordSpan> records = splitCsvRecords(buffer);
+        if (records.empty()) {
+            std::cout << "Successfully loaded 0 words from processed file: " << filename << std::endl;
+            return wordList;
+        }
 
-        while (readCsvRecord(file, line, lineNum)) {
-            WordInfo info;
+        // Optional: Skip header row if your CSV has one (records[0])
+        const std::size_t firstRecord = 1;
+        const std::size_t recordCount = records.size() - firstRecord;
+
+        struct ChunkResult {
+            std::vector<WordInfo> words;
+            std::vector<std::uint64_t> offsets; // Record start for each accepted word
+            std::string warnings;               // Printed after the merge so they stay in file order
+        };
+
+        ThreadPool& pool = ThreadPool::shared();
+        const std::size_t recordsPerChunk = 2048;
+        const std::size_t chunkCount = (recordCount + recordsPerChunk - 1) / recordsPerChunk;
+        std::vector<ChunkResult> chunks(chunkCount);
+
+        pool.parallelFor(chunkCount, [&](std::size_t chunkIdx) {
+            ChunkResult& out = chunks[chunkIdx];
+            const std::size_t begin = firstRecord + chunkIdx * recordsPerChunk;
+            const std::size_t end = std::min(records.size(), begin + recordsPerChunk);
+            out.words.reserve(end - begin);
+            std::ostringstream warnings;
+            std::string line;
+
+            for (std::size_t r = begin; r < end; ++r) {
+                const CsvRecordSpan& span = records[r];
+                const int lineNum = span.lastLine; // Physical line the record ends on, as before
+                recordText(buffer, span, line);
+                WordInfo info;
+
+                try {
+                    std::vector<std::string> fields = parseCsvLine(line);
+                    int fieldIndex = static_cast<int>(fields.size());
+
+                    if (fieldIndex > 0) {
+                        info.text = trimString(fields[0]);
+                        std::transform(info.text.begin(), info.text.end(), info.text.begin(),
+                            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                    }
+                    if (fieldIndex > 1) info.rarity = trimString(fields[1]).empty() ? 0 : std::stoi(trimString(fields[1]));
+                    // pos / definition / sentence (fields 2-4) stay in the file, see WordDetailsStore
 
-            try {
-                std::vector<std::string> fields = parseCsvLine(line);
-                int fieldIndex = static_cast<int>(fields.size());
+                    // Basic validation
+                    if (fieldIndex >= 2 && !info.text.empty()) {
+                        out.words.push_back(std::move(info));
+                        out.offsets.push_back(span.begin);
+                    }
+                    else if (!line.empty()) {
+                        warnings << "Warning: Skipping malformed line " << lineNum << " in " << filename << " (parsed " << fieldIndex << " fields)" << '\n';
+                    }
 
-                if (fieldIndex > 0) {
-                    info.text = trimString(fields[0]);
-                    std::transform(info.text.begin(), info.text.end(), info.text.begin(),
-                        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
                 }
-                if (fieldIndex > 1) info.rarity = trimString(fields[1]).empty() ? 0 : std::stoi(trimString(fields[1]));
-                if (fieldIndex > 2) info.pos = trimString(fields[2]);
-                if (fieldIndex > 3) info.definition = trimString(fields[3]);
-                if (fieldIndex > 4) info.sentence = trimString(fields[4]);
-
-                // Basic validation
-                if (fieldIndex >= 2 && !info.text.empty()) {
-                    wordList.push_back(info);
+                catch (const std::invalid_argument& ia) {
+                    warnings << "Warning: Invalid number format on line " << lineNum << " in " << filename << ". Line content: [" << line << "]. Skipping line. Error: " << ia.what() << '\n';
                 }
-                else if (!line.empty()) {
-                    std::cerr << "Warning: Skipping malformed line " << lineNum << " in " << filename << " (parsed " << fieldIndex << " fields)" << std::endl;
+                catch (const std::out_of_range& oor) {
+                    warnings << "Warning: Number out of range on line " << lineNum << " in " << filename << ". Line content: [" << line << "]. Skipping line. Error: " << oor.what() << '\n';
+                }
+                catch (const std::exception& e) {
+                    warnings << "Warning: Unexpected error parsing line " << lineNum << " in " << filename << ". Skipping line. Error: " << e.what() << '\n';
                 }
-
-            }
-            catch (const std::invalid_argument& ia) {
-                std::cerr << "Warning: Invalid number format on line " << lineNum << " in " << filename << ". Line content: [" << line << "]. Skipping line. Error: " << ia.what() << std::endl;
-            }
-            catch (const std::out_of_range& oor) {
-                std::cerr << "Warning: Number out of range on line " << lineNum << " in " << filename << ". Line content: [" << line << "]. Skipping line. Error: " << oor.what() << std::endl;
             }
-            catch (const std::exception& e) {
-                std::cerr << "Warning: Unexpected error parsing line " << lineNum << " in " << filename << ". Skipping line. Error: " << e.what() << std::endl;
+            out.warnings = warnings.str();
+        });
+
+        // Merge in input order
+        std::size_t total = 0;
+        for (const auto& chunk : chunks) total += chunk.words.size();
+        wordList.reserve(total);
+        for (auto& chunk : chunks) {
+            if (!chunk.warnings.empty()) std::cerr << chunk.warnings << std::flush;
+            for (std::size_t i = 0; i < chunk.words.size(); ++i) {
+                if (details) chunk.words[i].detailsId = details->addCsvRecord(chunk.offsets[i]);
+                wordList.push_back(std::move(chunk.words[i]));
             }
         }
 
-        file.close();
         std::cout << "Successfully loaded " << wordList.size() << " words from processed file: " << filename << std::endl;
         return wordList;
     }
 
 
+    //--------------------------------------------------------------------
+    //  WordDetailsStore
+    //--------------------------------------------------------------------
+    WordDetailsStore::WordDetailsStore(std::size_t cacheSize)
+        : m_cacheSize(std::max<std::size_t>(1, cacheSize)) {
+    }
+
+    WordDetailsStore::~WordDetailsStore() = default;
+
+
+    void WordDetailsStore::attachCsv(const std::string& filename) {
+        clear();
+        m_csvPath = filename;
+    }
+
+
+    std::uint32_t WordDetailsStore::addCsvRecord(std::uint64_t byteOffset) {
+        m_csvRecordOffsets.push_back(byteOffset);
+        return static_cast<std::uint32_t>(m_csvRecordOffsets.size() - 1);
+    }
+
+
+    void WordDetailsStore::attachImage(std::unique_ptr<CompiledDictionary> image) {
+        clear();
+        m_image = std::move(image);
+    }
+
+
+    void WordDetailsStore::clear() {
+        m_csvPath.clear();
+        m_csvRecordOffsets.clear();
+        if (m_csvFile.is_open()) m_csvFile.close();
+        m_image.reset();
+        m_lru.clear();
+        m_lruIndex.clear();
+    }
+
+
+    const WordDetails& WordDetailsStore::get(std::uint32_t detailsId) const {
+        if (detailsId == WordInfo::NO_DETAILS) return m_empty;
+
+        auto it = m_lruIndex.find(detailsId);
+        if (it != m_lruIndex.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second); // Move to front
+            return m_lru.front().second;
+        }
+
+        m_lru.emplace_front(detailsId, m_fetch(detailsId));
+        m_lruIndex[detailsId] = m_lru.begin();
+        if (m_lru.size() > m_cacheSize) {
+            m_lruIndex.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+        return m_lru.front().second;
+    }
+
+
+    WordDetails WordDetailsStore::m_fetch(std::uint32_t detailsId) const {
+        WordDetails result;
+
+        if (m_image) {
+            if (detailsId < m_image->size()) {
+                result.pos = std::string(m_image->pos(detailsId));
+                result.definition = std::string(m_image->definition(detailsId));
+                result.sentence = std::string(m_image->sentence(detailsId));
+            }
+            return result;
+        }
+
+        if (detailsId >= m_csvRecordOffsets.size()) return result;
+        if (!m_csvFile.is_open()) {
+            m_csvFile.open(m_csvPath, std::ios::binary);
+            if (!m_csvFile.is_open()) {
+                std::cerr << "Warning: Could not reopen " << m_csvPath << " to read word details." << std::endl;
+                return result;
+            }
+        }
+
+        m_csvFile.clear(); // Reset EOF from a previous read of the last record
+        m_csvFile.seekg(static_cast<std::streamoff>(m_csvRecordOffsets[detailsId]));
+        std::string record;
+        int unusedLineNum = 0;
+        if (!readCsvRecord(m_csvFile, record, unusedLineNum)) return result;
+
+        std::vector<std::string> fields = parseCsvLine(record);
+        if (fields.size() > 2) result.pos = trimString(fields[2]);
+        if (fields.size() > 3) result.definition = trimString(fields[3]);
+        if (fields.size() > 4) result.sentence = trimString(fields[4]);
+        return result;
+    }
+
+
     // *** DEFINITION for withLength ***
     std::vector<WordInfo> withLength(const std::vector<WordInfo>& wordList, std::size_t len) {
         std::vector<WordInfo> result;
@@ -167,27 +394,12 @@ namespace Words {
             return false; // A word isn't its own sub-word in this context
         }
 
-        // Use frequency maps for efficient checking
-        std::map<char, int> baseFreq;
-        for (char c : base) {
-            baseFreq[std::tolower(c)]++;
-        }
-
-        std::map<char, int> subFreq;
-        for (char c : sub) {
-            subFreq[std::tolower(c)]++;
-        }
-
-        // Check if every character in 'sub' is present in 'base' with sufficient frequency
-        for (const auto& pair : subFreq) {
-            char subChar = pair.first;
-            int subCount = pair.second;
-            if (baseFreq.find(subChar) == baseFreq.end() || baseFreq[subChar] < subCount) {
-                return false; // Character not found in base or not enough occurrences
-            }
+        LetterSignature subSig = makeSignature(sub);
+        LetterSignature baseSig = makeSignature(base);
+        if (subSig.hasNonLetters) {
+            return fitsByteCounts(sub, base);
         }
-
-        return true; // All characters in 'sub' are accounted for in 'base'
+        return fitsWithin(subSig, baseSig); // All characters in 'sub' are accounted for in 'base'
     }
 
 
@@ -195,63 +407,129 @@ namespace Words {
     // Finds all words in the dictionary that can be formed from the letters of 'base'
     // (excluding the base word itself).
     std::vector<WordInfo> subWords(const std::string& base, const std::vector<WordInfo>& wordList) {
+        SubWordIndex index(wordList);
+        return subWords(base, wordList, index);
+    }
+
+
+    std::vector<WordInfo> subWords(const std::string& base, const std::vector<WordInfo>& wordList, const SubWordIndex& index) {
         std::vector<WordInfo> result;
         if (base.empty()) { // Handle empty base case
             return result;
         }
 
-        std::string lowerBase = base;
-        std::transform(lowerBase.begin(), lowerBase.end(), lowerBase.begin(),
-            [](unsigned char c) { return std::tolower(c); }); // Use lambda for safety
-
-        std::map<char, int> baseFreq;
-        for (char c : lowerBase) {
-            baseFreq[c]++;
+        std::vector<std::size_t> indices;
+        index.findSubWords(base, wordList, indices);
+        result.reserve(indices.size());
+        for (std::size_t i : indices) {
+            result.push_back(wordList[i]); // Add the original WordInfo object
         }
+        std::cout << "DEBUG: Words::subWords found " << result.size() << " valid sub-words for base '" << base << "' (excluding base)." << std::endl; // Add debug output
+        return result;
+    }
 
-        for (const auto& info : wordList) { // Iterate through the entire dictionary
-            const std::string& potentialWord = info.text;
 
-            // Skip empty words or words longer than the base
-            if (potentialWord.empty() || potentialWord.length() > base.length()) {
-                continue;
+    LetterSignature makeSignature(const std::string& word) {
+        LetterSignature sig;
+        sig.length = static_cast<std::uint8_t>(std::min<std::size_t>(word.size(), 255));
+        for (char ch : word) {
+            unsigned char c = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(ch)));
+            if (c >= 'a' && c <= 'z') {
+                int slot = c - 'a';
+                sig.counts[slot]++;
+                sig.mask |= (1u << slot);
+            }
+            else {
+                sig.hasNonLetters = true;
             }
+        }
+        return sig;
+    }
 
-            std::string lowerWord = potentialWord;
-            std::transform(lowerWord.begin(), lowerWord.end(), lowerWord.begin(),
-                [](unsigned char c) { return std::tolower(c); });
 
-            // Check if it's the base word itself (case-insensitive) - skip if it is
-            if (lowerWord == lowerBase) {
-                continue;
-            }
+    bool fitsWithin(const LetterSignature& sub, const LetterSignature& base) {
+        if (sub.length > base.length) return false;
+        if ((sub.mask & ~base.mask) != 0) return false; // Uses a letter the base doesn't have
+        for (int i = 0; i < 26; ++i) {
+            if (sub.counts[i] > base.counts[i]) return false;
+        }
+        return true;
+    }
 
-            // Check using frequency map method
-            std::map<char, int> wordFreq;
-            bool possible = true;
-            for (char c : lowerWord) {
-                wordFreq[c]++;
-                // Early exit: If char not in base, or count exceeds base count, impossible.
-                auto it = baseFreq.find(c);
-                if (it == baseFreq.end() || wordFreq[c] > it->second) {
-                    possible = false;
-                    break;
-                }
-            }
 
-            if (possible) {
-                result.push_back(info); // Add the original WordInfo object
+    void SubWordIndex::build(const std::vector<WordInfo>& wordList) {
+        m_lengths.clear();
+        m_hasNonLetters.clear();
+        m_lengths.reserve(wordList.size());
+        m_hasNonLetters.reserve(wordList.size());
+        m_histograms.assign(wordList.size());
+
+        for (std::size_t i = 0; i < wordList.size(); ++i) {
+            LetterSignature sig = makeSignature(wordList[i].text);
+            m_histograms.set(i, sig.counts);
+            m_lengths.push_back(sig.length);
+            m_hasNonLetters.push_back(sig.hasNonLetters);
+        }
+    }
+
+
+    void SubWordIndex::findSubWords(const std::string& base, const std::vector<WordInfo>& wordList,
+        std::vector<std::size_t>& outIndices) const {
+        if (base.empty()) return;
+
+        const LetterSignature baseSig = makeSignature(base);
+        const std::size_t count = std::min(m_lengths.size(), wordList.size());
+
+        // Every word whose letters fit, HistogramTable::BLOCK_WORDS per bitmap entry
+        thread_local std::vector<std::uint32_t> bitmap;
+        m_histograms.fitsWithin(baseSig.counts, bitmap);
+
+        for (std::size_t block = 0; block < bitmap.size(); ++block) {
+            for (std::uint32_t bits = bitmap[block]; bits != 0; bits &= bits - 1) {
+                const std::size_t i = block * HistogramTable::BLOCK_WORDS + lowestSetBit(bits);
+                if (i >= count) break;
+
+                // Skip empty words or words longer than the base
+                if (m_lengths[i] == 0 || m_lengths[i] > baseSig.length) continue;
+
+                const std::string& text = wordList[i].text;
+                if (m_hasNonLetters[i] && !fitsByteCounts(text, base)) continue;
+
+                // Check if it's the base word itself (case-insensitive) - skip if it is
+                if (m_lengths[i] == baseSig.length && equalsIgnoreCase(text, base)) continue;
+
+                outIndices.push_back(i);
             }
         }
-        std::cout << "DEBUG: Words::subWords found " << result.size() << " valid sub-words for base '" << base << "' (excluding base)." << std::endl; // Add debug output
-        return result;
+    }
+
+
+    std::string canonicalLetters(const std::string& word) {
+        std::string letters = word;
+        std::transform(letters.begin(), letters.end(), letters.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        std::sort(letters.begin(), letters.end());
+        return letters;
+    }
+
+
+    std::size_t assignAnagramClasses(std::vector<WordInfo>& wordList) {
+        std::unordered_map<std::string, std::uint32_t> classIds;
+        classIds.reserve(wordList.size());
+        for (auto& info : wordList) {
+            auto inserted = classIds.emplace(canonicalLetters(info.text), static_cast<std::uint32_t>(classIds.size()));
+            info.anagramClass = inserted.first->second;
+        }
+        return classIds.size();
     }
 
 
     // *** DEFINITION for sortForGrid (FIXED) ***
     // Sorts by length ascending, then alphabetically (case-insensitive)
-    std::vector<WordInfo> sortForGrid(std::vector<WordInfo> v) { // Pass by value ok
-        std::sort(v.begin(), v.end(), [](const WordInfo& a, const WordInfo& b) {
+    std::vector<WordId> sortForGrid(std::vector<WordId> ids, const std::vector<WordInfo>& wordList) { // Pass by value ok
+        std::sort(ids.begin(), ids.end(), [&wordList](WordId idA, WordId idB) {
+            const WordInfo& a = wordList[idA];
+            const WordInfo& b = wordList[idB];
             if (a.text.length() != b.text.length()) {
                 return a.text.length() < b.text.length(); // Shorter first
             }
@@ -264,7 +542,7 @@ namespace Words {
                 });
             // Original (case-sensitive): return a.text < b.text;
             });
-        return v; // Return the sorted vector
+        return ids; // Return the sorted vector
     }
 
 
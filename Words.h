@@ -2,22 +2,80 @@
 #ifndef WORDS_H
 #define WORDS_H
 
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set> // Keep if used by other functions
-#include "GameData.h" // Include necessary struct definition (WordInfo)
+#include "WordInfo.h" // Include necessary struct definition (WordInfo)
+#include "HistogramKernel.h"
 
 //--------------------------------------------------------------------
 //  Word logic helpers (Declarations)
 //--------------------------------------------------------------------
 namespace Words {
 
+    class CompiledDictionary;
+
+    //--------------------------------------------------------------------
+    //  Lazily loaded word details (popup-only text)
+    //--------------------------------------------------------------------
+    struct WordDetails {
+        std::string pos;
+        std::string definition;
+        std::string sentence;
+    };
+
+    // Resolves WordInfo::detailsId to the part of speech, definition and sentence.
+    // Nothing is kept resident: CSV-backed ids index the record offsets collected by
+    // addCsvRecord() (not byte offsets themselves), image-backed ids are entries of the
+    // mapped image. A small LRU sits in front so hovering the same words does not
+    // re-read them every frame.
+    class WordDetailsStore {
+    public:
+        static constexpr std::size_t DEFAULT_CACHE_SIZE = 32;
+
+        explicit WordDetailsStore(std::size_t cacheSize = DEFAULT_CACHE_SIZE);
+        ~WordDetailsStore();
+        WordDetailsStore(const WordDetailsStore&) = delete;
+        WordDetailsStore& operator=(const WordDetailsStore&) = delete;
+
+        // Switches the store to a CSV file; record offsets are added while loading
+        void attachCsv(const std::string& filename);
+        // Returns the detailsId of the record starting at 'byteOffset'
+        std::uint32_t addCsvRecord(std::uint64_t byteOffset);
+        // Switches the store to a mapped image; detailsId == image entry index
+        void attachImage(std::unique_ptr<CompiledDictionary> image);
+        void clear();
+
+        // Returned reference stays valid until the next get() call.
+        // Unknown ids (e.g. WordInfo::NO_DETAILS) give empty details.
+        const WordDetails& get(std::uint32_t detailsId) const;
+
+    private:
+        WordDetails m_fetch(std::uint32_t detailsId) const;
+
+        std::string m_csvPath;
+        std::vector<std::uint64_t> m_csvRecordOffsets;
+        mutable std::ifstream m_csvFile;
+        std::unique_ptr<CompiledDictionary> m_image;
+
+        std::size_t m_cacheSize;
+        mutable std::list<std::pair<std::uint32_t, WordDetails>> m_lru; // Most recently used first
+        mutable std::unordered_map<std::uint32_t, std::list<std::pair<std::uint32_t, WordDetails>>::iterator> m_lruIndex;
+        WordDetails m_empty;
+    };
+
     // Function to load words AND rarity from CSV (Original, keep if needed elsewhere)
     // std::vector<WordInfo> loadWordListWithRarity(const std::string& file); // Can likely be removed if not used
 
-    // *** ADD THIS DECLARATION FOR THE NEW FUNCTION ***
-    std::vector<WordInfo> loadProcessedWordList(const std::string& filename);
-    // ************************************************
+    // Loads text, rarity and metrics from the CSV. When 'details' is given it is
+    // attached to the file and each WordInfo::detailsId refers to its record there.
+    std::vector<WordInfo> loadProcessedWordList(const std::string& filename, WordDetailsStore* details = nullptr);
 
     // Function to get words of a specific length from the loaded list
     std::vector<WordInfo> withLength(const std::vector<WordInfo>& wordList, std::size_t len);
@@ -29,8 +87,60 @@ namespace Words {
     // Note: Ensure this function works correctly with the extended WordInfo if it relies on more than text/rarity
     std::vector<WordInfo> subWords(const std::string& base, const std::vector<WordInfo>& wordList);
 
-    // Function to sort WordInfo objects for grid display (by length, then alpha)
-    std::vector<WordInfo> sortForGrid(std::vector<WordInfo> v); // Pass by value is okay if you modify copy
+    // Sorted, lowercase letters of a word ("Stone" -> "enost"); equal for anagrams
+    std::string canonicalLetters(const std::string& word);
+
+    // Gives every word an anagram class id (WordInfo::anagramClass) so that words made of
+    // the same letters share one id. Ids are dense, 0..count-1, in order of first appearance.
+    // Returns the number of classes.
+    std::size_t assignAnagramClasses(std::vector<WordInfo>& wordList);
+
+    // Function to sort words for grid display (by length, then alpha); ids index 'wordList'
+    std::vector<WordId> sortForGrid(std::vector<WordId> ids, const std::vector<WordInfo>& wordList); // Pass by value is okay if you modify copy
+
+    //--------------------------------------------------------------------
+    //  Letter signatures (fixed 26-slot histogram, no heap allocation)
+    //--------------------------------------------------------------------
+    struct LetterSignature {
+        std::uint32_t mask = 0;               // Bit i set when letter ('a' + i) occurs at least once
+        std::uint8_t length = 0;              // Total number of characters in the word
+        bool hasNonLetters = false;           // Word contains bytes outside a-z (accents, digits, ...)
+        std::array<std::uint8_t, 26> counts{}; // Occurrences of each letter a-z
+    };
+
+    // Builds the signature of a word (case-insensitive)
+    LetterSignature makeSignature(const std::string& word);
+
+    // True if every letter of 'sub' is available in 'base' with sufficient count.
+    // Words with non a-z bytes are not decided here; see SubWordIndex for the exact fallback.
+    bool fitsWithin(const LetterSignature& sub, const LetterSignature& base);
+
+    // Prebuilt signature table for a word list. Built once after loading;
+    // sub-word queries are then one batch histogram test (see HistogramKernel.h)
+    // plus exact checks on the words it lets through.
+    class SubWordIndex {
+    public:
+        SubWordIndex() = default;
+        explicit SubWordIndex(const std::vector<WordInfo>& wordList) { build(wordList); }
+
+        void build(const std::vector<WordInfo>& wordList);
+        bool empty() const { return m_lengths.empty(); }
+        std::size_t size() const { return m_lengths.size(); }
+
+        // Appends the indices of every sub-word of 'base' (excluding 'base' itself).
+        // 'wordList' must be the list the index was built from; order follows it.
+        void findSubWords(const std::string& base, const std::vector<WordInfo>& wordList,
+            std::vector<std::size_t>& outIndices) const;
+
+    private:
+        HistogramTable m_histograms; // Letter counts, transposed for the SIMD kernel
+        std::vector<std::uint8_t> m_lengths;
+        std::vector<bool> m_hasNonLetters;
+    };
+
+    // Same result as subWords(base, wordList) but answered from a prebuilt index.
+    // 'index' must have been built from 'wordList'.
+    std::vector<WordInfo> subWords(const std::string& base, const std::vector<WordInfo>& wordList, const SubWordIndex& index);
 
 } // End namespace Words
 
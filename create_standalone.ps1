@@ -70,6 +70,18 @@ foreach ($file in $dataFiles) {
     }
 }
 
+# Optional compiled word list (built by tools/DictionaryCompiler); the game falls back to the CSV without it.
+# Root-word metrics (built by tools/WordMetrics) let the game pick well-sized base words.
+$optionalDataFiles = @("words_processed.wpd", "words_processed.metrics.csv")
+foreach ($file in $optionalDataFiles) {
+    if (Test-Path $file) {
+        Copy-Item -Path $file -Destination "$OutputFolder\$file" -Force
+        Write-Host "  $file copied" -ForegroundColor Green
+    } else {
+        Write-Host "  $file not found (optional, run WordMetrics / DictionaryCompiler)" -ForegroundColor Yellow
+    }
+}
+
 # Check if we need SFML DLLs (only for Debug builds - Release uses static linking)
 if ($BuildConfig -eq "Debug") {
     Write-Host ""
@@ -133,4 +145,6 @@ Write-Host "    SFML_TestProject.exe" -ForegroundColor White
 Write-Host "    fonts\arialbd.ttf" -ForegroundColor White
 Write-Host "    assets\ (all images, sounds, music)" -ForegroundColor White
 Write-Host "    words_processed.csv" -ForegroundColor White
+Write-Host "    words_processed.wpd (optional)" -ForegroundColor White
+Write-Host "    words_processed.metrics.csv (optional)" -ForegroundColor White
 Write-Host ""
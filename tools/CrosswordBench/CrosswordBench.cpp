@@ -0,0 +1,246 @@
+// Crossword generator benchmark: speed and layout quality of generateCrossword
+// on real puzzle word sets, as one JSON report.
+//
+// Usage: CrosswordBench [--sets N] [--seed S] [--words words_processed.csv] [--out report.json | -]
+//                       [--trials N] [--budget-ms MS] [--accept A] [--engine greedy|beam] [--beam-width W]
+//                       [--shape wide|balanced|compact|dense|symmetric] [--trial-samples K]
+//   --sets    word sets per crossword difficulty (10/15/20 words at most), default 50
+//   --seed    default 1, so two builds are compared on the same word sets
+//   --trials / --budget-ms / --accept / --engine / --beam-width / --shape  options of each
+//             per-puzzle run (see CrosswordOptions), defaults as in CrosswordOptions
+//   --trial-samples  single-trial runs per word set for the per-trial latency, default 5
+//   --out     default "-" (stdout). Diagnostics go to stderr.
+//
+// Word sets come from PuzzleGenerator in Crossword mode (the words it offers to
+// the layout), so they match what the game lays out. Per-trial latency times one
+// trial on the calling thread; per-puzzle latency times a whole generateCrossword
+// call, whose trials run in parallel on the shared pool. Quality is averaged over
+// the per-puzzle layouts:
+//   placedFraction        placed words / offered words
+//   aspect                gridCols / gridRows
+//   intersectionsPerWord  shared cells / placed words
+//   fill                  letter cells / grid cells
+//   symmetry              see crosswordSymmetry()
+
+#include "CompiledDictionary.h"
+#include "Crossword.h"
+#include "PuzzleGenerator.h"
+#include "RootPool.h"
+#include "Seed.h"
+#include "ThreadPool.h"
+#include "Words.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Level {
+        DifficultyLevel difficulty;
+        const char* name;
+        int maxWords;
+    };
+
+    const Level LEVELS[] = {
+        { DifficultyLevel::Easy,   "easy",   CROSSWORD_EASY_MAX_SOLUTIONS },
+        { DifficultyLevel::Medium, "medium", CROSSWORD_MEDIUM_MAX_SOLUTIONS },
+        { DifficultyLevel::Hard,   "hard",   CROSSWORD_HARD_MAX_SOLUTIONS },
+    };
+
+    const std::uint64_t WORD_SET_STREAM = 1;
+    const std::uint64_t TRIAL_STREAM = 2;
+    const std::uint64_t PUZZLE_STREAM = 3;
+
+    struct LevelReport {
+        std::size_t sets = 0;
+        double offeredWords = 0.0;
+        std::vector<double> trialMs;
+        std::vector<double> puzzleMs;
+        double placedFraction = 0.0;
+        double aspect = 0.0;
+        double intersectionsPerWord = 0.0;
+        double fill = 0.0;
+        double symmetry = 0.0;
+        double trialsUsed = 0.0;
+    };
+
+    // Nearest-rank percentile of sorted samples
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        std::size_t rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.999999);
+        rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+        return sorted[rank - 1];
+    }
+
+    void writeLatency(std::ostream& out, std::vector<double> samples) {
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        out << "{\"samples\":" << samples.size()
+            << ",\"mean\":" << (samples.empty() ? 0.0 : sum / static_cast<double>(samples.size()))
+            << ",\"p50\":" << percentile(samples, 50.0) << ",\"p90\":" << percentile(samples, 90.0)
+            << ",\"p99\":" << percentile(samples, 99.0) << ",\"max\":" << (samples.empty() ? 0.0 : samples.back()) << '}';
+    }
+
+    // Times fn() in milliseconds with the libraries' std::cout chatter switched off
+    template <typename Fn>
+    double timeQuietly(Fn&& fn) {
+        std::streambuf* saved = std::cout.rdbuf(nullptr);
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const auto end = std::chrono::steady_clock::now();
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    int setsPerLevel = 50;
+    int trialSamples = 5;
+    std::uint64_t baseSeed = 1;
+    std::string wordsPath = "words_processed.csv";
+    std::string outPath = "-";
+    CrosswordOptions options;
+    std::string engineArg = "greedy";
+    std::string shapeArg = "wide";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--sets" && hasValue) setsPerLevel = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) baseSeed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--words" && hasValue) wordsPath = argv[++i];
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--trials" && hasValue) options.maxTrials = std::atoi(argv[++i]);
+        else if (arg == "--budget-ms" && hasValue) options.timeBudgetMs = std::atof(argv[++i]);
+        else if (arg == "--accept" && hasValue) options.acceptAspect = std::atof(argv[++i]);
+        else if (arg == "--engine" && hasValue) engineArg = argv[++i];
+        else if (arg == "--shape" && hasValue) shapeArg = argv[++i];
+        else if (arg == "--beam-width" && hasValue) options.beamWidth = std::atoi(argv[++i]);
+        else if (arg == "--trial-samples" && hasValue) trialSamples = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: CrosswordBench [--sets N] [--seed S] [--words file.csv] [--out file|-]\n"
+                << "                      [--trials N] [--budget-ms MS] [--accept A] [--engine greedy|beam] [--beam-width W]\n"
+                << "                      [--shape wide|balanced|compact|dense|symmetric] [--trial-samples K]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (engineArg == "beam") options.engine = CrosswordEngine::Beam;
+    const bool shapeKnown = crosswordShapeFromName(shapeArg, options.shape);
+    if (!shapeKnown || setsPerLevel <= 0 || trialSamples < 0 || options.maxTrials <= 0 || options.timeBudgetMs < 0.0
+        || options.beamWidth <= 0 || (engineArg != "greedy" && engineArg != "beam")) {
+        std::cerr << "Invalid --sets, --trial-samples, --trials, --budget-ms, --engine, --beam-width or --shape." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The report goes to the real stdout (or a file); everything the libraries print goes to stderr
+    std::streambuf* stdoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ofstream outFile;
+    std::ostream json(stdoutBuf);
+    if (outPath != "-") {
+        outFile.open(outPath, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not open " << outPath << " for writing." << std::endl;
+            return EXIT_FAILURE;
+        }
+        json.rdbuf(outFile.rdbuf());
+    }
+
+    Words::WordDetailsStore details;
+    std::vector<WordInfo> words = Words::loadWordList(wordsPath, details);
+    if (words.empty()) {
+        std::cerr << "Nothing to do: " << wordsPath << " is missing or empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+    Words::assignAnagramClasses(words);
+    Words::SubWordIndex index(words);
+    Words::RootPool roots;
+    roots.build(words);
+    PuzzleGenerator generator(words, index, roots);
+    CrosswordOptions drawOptions; // Only the offered words are used, keep the layout step cheap
+    drawOptions.maxTrials = 1;
+    generator.setCrosswordOptions(drawOptions);
+
+    CrosswordOptions trialOptions = options;
+    trialOptions.maxTrials = 1;
+    trialOptions.timeBudgetMs = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<LevelReport> reports;
+    for (const Level& level : LEVELS) {
+        LevelReport report;
+        for (int s = 0; s < setsPerLevel; ++s) {
+            PuzzleRequest request;
+            request.mode = GameMode::Crossword;
+            request.difficulty = level.difficulty;
+            request.seed = deriveSeed(deriveSeed(baseSeed, WORD_SET_STREAM), static_cast<std::uint64_t>(level.maxWords) * 1000003u + s);
+            std::vector<WordId> setIds;
+            timeQuietly([&]() { setIds = generator.generate(request).crosswordInputWords; });
+            if (setIds.empty()) continue;
+            const CrosswordWords set(setIds, words);
+
+            for (int k = 0; k < trialSamples; ++k) {
+                const std::uint64_t seed = deriveSeed(deriveSeed(request.seed, TRIAL_STREAM), static_cast<std::uint64_t>(k));
+                report.trialMs.push_back(timeQuietly([&]() { generateCrossword(set, seed, trialOptions); }));
+            }
+
+            CrosswordResult result;
+            report.puzzleMs.push_back(timeQuietly([&]() {
+                result = generateCrossword(set, deriveSeed(request.seed, PUZZLE_STREAM), options);
+            }));
+
+            const double placed = static_cast<double>(result.placedIndices.size());
+            report.sets++;
+            report.offeredWords += static_cast<double>(set.size());
+            report.placedFraction += placed / static_cast<double>(set.size());
+            report.aspect += result.gridRows > 0 ? result.gridCols / static_cast<double>(result.gridRows) : 0.0;
+            report.intersectionsPerWord += placed > 0 ? static_cast<double>(result.sharedCells.size()) / placed : 0.0;
+            std::size_t letters = 0;
+            for (std::size_t index : result.placedIndices) letters += set.text(index).size();
+            const double area = static_cast<double>(result.gridRows) * result.gridCols;
+            report.fill += area > 0.0 ? static_cast<double>(letters - result.sharedCells.size()) / area : 0.0;
+            report.symmetry += crosswordSymmetry(result, set);
+            report.trialsUsed += result.trialsUsed;
+        }
+        reports.push_back(std::move(report));
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    json << std::setprecision(6);
+    json << "{\"config\":{\"seed\":" << baseSeed << ",\"setsPerLevel\":" << setsPerLevel << ",\"trialSamples\":" << trialSamples
+        << ",\"engine\":\"" << engineArg << "\",\"shape\":\"" << shapeArg << "\",\"beamWidth\":" << options.beamWidth << ",\"maxTrials\":" << options.maxTrials
+        << ",\"timeBudgetMs\":" << options.timeBudgetMs << ",\"acceptAspect\":" << options.acceptAspect
+        << ",\"threads\":" << ThreadPool::shared().size() + 1 << ",\"words\":\"";
+    for (char c : wordsPath) { if (c == '"' || c == '\\') json << '\\'; json << c; }
+    json << "\"},\"levels\":[";
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        const LevelReport& r = reports[i];
+        const double n = r.sets > 0 ? static_cast<double>(r.sets) : 1.0;
+        if (i) json << ',';
+        json << "{\"difficulty\":\"" << LEVELS[i].name << "\",\"maxWords\":" << LEVELS[i].maxWords << ",\"sets\":" << r.sets
+            << ",\"avgWords\":" << r.offeredWords / n << ",\"trialLatencyMs\":";
+        writeLatency(json, r.trialMs);
+        json << ",\"puzzleLatencyMs\":";
+        writeLatency(json, r.puzzleMs);
+        json << ",\"placedFraction\":" << r.placedFraction / n << ",\"aspect\":" << r.aspect / n
+            << ",\"intersectionsPerWord\":" << r.intersectionsPerWord / n << ",\"fill\":" << r.fill / n
+            << ",\"symmetry\":" << r.symmetry / n << ",\"trialsUsed\":" << r.trialsUsed / n << '}';
+    }
+    json << "]}\n";
+    json.flush();
+
+    std::cerr << "Benchmarked " << setsPerLevel << " word sets per difficulty in " << seconds << "s." << std::endl;
+    std::cout.rdbuf(stdoutBuf);
+    return json ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,56 @@
+// Offline compiler: words_processed.csv -> words_processed.wpd
+//
+// Usage: DictionaryCompiler [input.csv] [output.wpd]
+//   Defaults to words_processed.csv and the .wpd path next to it.
+// Re-run after every change to the CSV; the game ignores an image that is
+// older than (or was built from a different size of) its CSV.
+// Root-word metrics are baked in from words_processed.metrics.csv when present
+// (run WordMetrics first).
+
+#include "Words.h"
+#include "CompiledDictionary.h"
+#include "WordMetrics.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    const std::string csvPath = (argc > 1) ? argv[1] : "words_processed.csv";
+    const std::string imagePath = (argc > 2) ? argv[2] : Words::compiledPathFor(csvPath);
+
+    Words::WordDetailsStore details;
+    std::vector<WordInfo> words = Words::loadProcessedWordList(csvPath, &details);
+    if (words.empty()) {
+        std::cerr << "Nothing to compile: " << csvPath << " is missing or empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string metricsPath = Words::metricsPathFor(csvPath);
+    std::size_t withMetrics = Words::applyWordMetrics(words, metricsPath);
+    if (withMetrics > 0) {
+        std::cout << "Including metrics for " << withMetrics << " words from " << metricsPath << std::endl;
+    }
+    else {
+        std::cerr << "Warning: Compiling without root-word metrics (" << metricsPath << " missing or stale)." << std::endl;
+    }
+
+    if (!Words::writeCompiledWordList(words, details, imagePath, csvPath)) {
+        return EXIT_FAILURE;
+    }
+
+    // Round-trip check so a bad image is caught here rather than at game startup
+    Words::CompiledDictionary check;
+    if (!check.open(imagePath, csvPath) || check.size() != words.size()) {
+        std::cerr << "Verification failed: could not read back " << imagePath << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        if (check.text(i) != words[i].text || check.definition(i) != details.get(words[i].detailsId).definition) {
+            std::cerr << "Verification failed at entry " << i << " ('" << words[i].text << "')." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
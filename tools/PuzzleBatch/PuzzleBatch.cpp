@@ -0,0 +1,284 @@
+// Headless batch generator: writes puzzle packs as JSON lines, no window needed.
+//
+// Usage: PuzzleBatch [--count N] [--mode casual|crossword|both] [--seed S]
+//                    [--words words_processed.csv] [--out puzzles.jsonl | -]
+//                    [--trials N] [--budget-ms MS] [--engine greedy|beam] [--beam-width W]
+//                    [--shape wide|balanced|compact|dense|symmetric] [--cache crossword_layouts.cache]
+//        PuzzleBatch --replay KEY [--words ...] [--out ...] [--trials N] [--engine ...]
+//   --count  puzzles per difficulty (Easy, Medium, Hard) and mode, default 10
+//   --mode   default casual
+//   --seed   base seed, default from the clock; printed so a pack can be rebuilt
+//   --out    default "-" (stdout). Diagnostics always go to stderr.
+//   --trials / --budget-ms  crossword search budget per puzzle (default 20 trials, no
+//            time limit). A time limit makes layouts depend on machine speed.
+//   --engine crossword layout engine, default greedy (see CrosswordEngine). Not part
+//            of the key: replay with the same --engine/--beam-width/--trials/--shape.
+//   --shape  crossword layout shape preset, default wide (see CrosswordShapePreset)
+//   --cache  crossword layout cache to use and update (see CrosswordCache). Layouts
+//            then depend on the cache contents, so keys only replay without it.
+//   --replay regenerates the single puzzle with that key (see puzzleKey(); the
+//            game logs one per puzzle and every output line carries one)
+//
+// Each difficulty's puzzles form one session: indices run 0..N-1 (the last Hard
+// puzzle uses the rarest roots, as in the game) and no base word repeats an
+// anagram class within it. Puzzles are generated in parallel on every core, and
+// the output depends only on the seed, count, mode and word list (and --cache).
+
+#include "CompiledDictionary.h"
+#include "CrosswordCache.h"
+#include "PuzzleGenerator.h"
+#include "RootPool.h"
+#include "Seed.h"
+#include "ThreadPool.h"
+#include "Words.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Job {
+        PuzzleRequest request;
+        Puzzle puzzle;
+    };
+
+    const char* modeName(GameMode mode) { return mode == GameMode::Crossword ? "crossword" : "casual"; }
+
+    const char* difficultyName(DifficultyLevel difficulty) {
+        switch (difficulty) {
+        case DifficultyLevel::Easy:   return "easy";
+        case DifficultyLevel::Medium: return "medium";
+        case DifficultyLevel::Hard:   return "hard";
+        default:                      return "none";
+        }
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& text) {
+        static const char* hex = "0123456789abcdef";
+        out << '"';
+        for (unsigned char c : text) {
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+                else out << static_cast<char>(c); // UTF-8 passes through
+            }
+        }
+        out << '"';
+    }
+
+    void writeJsonLine(std::ostream& out, const Job& job, const std::vector<WordInfo>& words) {
+        const Puzzle& p = job.puzzle;
+        out << "{\"key\":";
+        writeJsonString(out, puzzleKey(job.request));
+        out << ",\"mode\":\"" << modeName(job.request.mode) << "\",\"difficulty\":\"" << difficultyName(job.request.difficulty)
+            << "\",\"index\":" << job.request.puzzleIndex << ",\"seed\":" << job.request.seed << ",\"base\":";
+        writeJsonString(out, p.baseWord);
+        out << ",\"letters\":";
+        writeJsonString(out, p.base);
+
+        out << ",\"words\":[";
+        std::set<std::string> gridTexts;
+        for (std::size_t i = 0; i < p.sorted.size(); ++i) {
+            if (i) out << ',';
+            out << "{\"text\":";
+            const WordInfo& info = words[p.sorted[i]];
+            writeJsonString(out, info.text);
+            out << ",\"rarity\":" << info.rarity;
+            if (i < p.crosswordPlacements.size()) {
+                const CrosswordPlacement& cp = p.crosswordPlacements[i];
+                out << ",\"row\":" << cp.gridRow << ",\"col\":" << cp.gridCol
+                    << ",\"dir\":\"" << (cp.dir == Direction::Horizontal ? "across" : "down") << '"';
+            }
+            out << '}';
+            gridTexts.insert(info.text);
+        }
+        out << ']';
+
+        out << ",\"bonus\":[";
+        bool first = true;
+        std::set<std::string> bonusTexts;
+        for (WordId id : p.allPotentialSolutions) {
+            const WordInfo& info = words[id];
+            if (gridTexts.count(info.text) || !bonusTexts.insert(info.text).second) continue;
+            if (!first) out << ',';
+            writeJsonString(out, info.text);
+            first = false;
+        }
+        out << ']';
+
+        if (job.request.mode == GameMode::Crossword) {
+            out << ",\"gridRows\":" << p.crosswordGridRows << ",\"gridCols\":" << p.crosswordGridCols
+                << ",\"trials\":" << p.crosswordTrials;
+        }
+        out << "}\n";
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    int count = 10;
+    std::string modeArg = "casual";
+    std::uint64_t baseSeed = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    std::string wordsPath = "words_processed.csv";
+    std::string outPath = "-";
+    std::string replayKey;
+    CrosswordOptions crosswordOptions;
+    std::string engineArg = "greedy";
+    std::string shapeArg = "wide";
+    std::string cachePath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--count" && hasValue) count = std::atoi(argv[++i]);
+        else if (arg == "--mode" && hasValue) modeArg = argv[++i];
+        else if (arg == "--seed" && hasValue) baseSeed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--words" && hasValue) wordsPath = argv[++i];
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--replay" && hasValue) replayKey = argv[++i];
+        else if (arg == "--trials" && hasValue) crosswordOptions.maxTrials = std::atoi(argv[++i]);
+        else if (arg == "--budget-ms" && hasValue) crosswordOptions.timeBudgetMs = std::atof(argv[++i]);
+        else if (arg == "--engine" && hasValue) engineArg = argv[++i];
+        else if (arg == "--shape" && hasValue) shapeArg = argv[++i];
+        else if (arg == "--beam-width" && hasValue) crosswordOptions.beamWidth = std::atoi(argv[++i]);
+        else if (arg == "--cache" && hasValue) cachePath = argv[++i];
+        else {
+            std::cerr << "Usage: PuzzleBatch [--count N] [--mode casual|crossword|both] [--seed S] [--words file.csv] [--out file|-]\n"
+                << "                   [--trials N] [--budget-ms MS] [--engine greedy|beam] [--beam-width W]\n"
+                << "                   [--shape wide|balanced|compact|dense|symmetric] [--cache file]\n"
+                << "       PuzzleBatch --replay KEY [--words file.csv] [--out file|-] [--trials N] [--engine greedy|beam] [--beam-width W] [--shape S]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (engineArg == "beam") crosswordOptions.engine = CrosswordEngine::Beam;
+    const bool shapeKnown = crosswordShapeFromName(shapeArg, crosswordOptions.shape);
+    if (!shapeKnown || count <= 0 || crosswordOptions.maxTrials <= 0 || crosswordOptions.timeBudgetMs < 0.0 || crosswordOptions.beamWidth <= 0
+        || (engineArg != "greedy" && engineArg != "beam") || (modeArg != "casual" && modeArg != "crossword" && modeArg != "both")) {
+        std::cerr << "Invalid --count, --mode, --trials, --budget-ms, --engine, --beam-width or --shape." << std::endl;
+        return EXIT_FAILURE;
+    }
+    Job replay;
+    if (!replayKey.empty() && !parsePuzzleKey(replayKey, replay.request)) {
+        std::cerr << "Invalid --replay key '" << replayKey << "' (expected seed:difficulty:mode[:index/count][:used=class,...])." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // JSON goes to the real stdout (or a file); everything the libraries print goes to stderr
+    std::streambuf* stdoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ofstream outFile;
+    std::ostream json(stdoutBuf);
+    if (outPath != "-") {
+        outFile.open(outPath, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not open " << outPath << " for writing." << std::endl;
+            return EXIT_FAILURE;
+        }
+        json.rdbuf(outFile.rdbuf());
+    }
+
+    Words::WordDetailsStore details;
+    std::vector<WordInfo> words = Words::loadWordList(wordsPath, details);
+    if (words.empty()) {
+        std::cerr << "Nothing to do: " << wordsPath << " is missing or empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::size_t classCount = Words::assignAnagramClasses(words);
+    Words::SubWordIndex index(words);
+    Words::RootPool roots;
+    roots.build(words);
+    PuzzleGenerator generator(words, index, roots);
+    CrosswordCache cache;
+    if (!cachePath.empty()) {
+        if (cache.load(cachePath)) std::cerr << "Loaded " << cache.size() << " crossword layouts from " << cachePath << std::endl;
+        crosswordOptions.cache = &cache;
+    }
+    generator.setCrosswordOptions(crosswordOptions);
+    auto saveCache = [&]() {
+        return cachePath.empty() || !cache.isDirty() || cache.save(cachePath);
+    };
+
+    if (!replayKey.empty()) {
+        replay.puzzle = generator.generate(replay.request);
+        writeJsonLine(json, replay, words);
+        json.flush();
+        std::cout.rdbuf(stdoutBuf);
+        return (json && saveCache()) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::vector<GameMode> modes;
+    if (modeArg != "crossword") modes.push_back(GameMode::Casual);
+    if (modeArg != "casual") modes.push_back(GameMode::Crossword);
+    const DifficultyLevel difficulties[] = { DifficultyLevel::Easy, DifficultyLevel::Medium, DifficultyLevel::Hard };
+
+    std::vector<Job> jobs;
+    for (GameMode mode : modes) {
+        for (DifficultyLevel difficulty : difficulties) {
+            for (int i = 0; i < count; ++i) {
+                const std::uint64_t slot = (static_cast<std::uint64_t>(mode) << 40) ^ (static_cast<std::uint64_t>(difficulty) << 32) ^ static_cast<std::uint64_t>(i);
+                Job job;
+                job.request.seed = deriveSeed(baseSeed, slot);
+                job.request.mode = mode;
+                job.request.difficulty = difficulty;
+                job.request.puzzleIndex = i;
+                job.request.puzzlesPerSession = count;
+                jobs.push_back(std::move(job));
+            }
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Every puzzle independently, in parallel
+    ThreadPool::shared().parallelFor(jobs.size(), [&](std::size_t j) {
+        jobs[j].puzzle = generator.generate(jobs[j].request);
+    });
+
+    // Session rule: one base per anagram class per (mode, difficulty). Clashes are
+    // rare, so they are re-rolled in order with a derived seed. Unlike passing the
+    // used classes to the generator, this keeps every line replayable from its key.
+    const int MAX_REROLLS = 64;
+    std::size_t regenerated = 0;
+    for (std::size_t sessionStart = 0; sessionStart < jobs.size(); sessionStart += static_cast<std::size_t>(count)) {
+        std::vector<bool> used(classCount, false);
+        for (std::size_t j = sessionStart; j < sessionStart + static_cast<std::size_t>(count); ++j) {
+            Job& job = jobs[j];
+            auto classOf = [&](const Puzzle& p) {
+                return p.rootIndex == Words::RootPool::NO_ROOT ? WordInfo::NO_ANAGRAM_CLASS : roots.root(p.rootIndex).anagramClass;
+            };
+            std::uint32_t cls = classOf(job.puzzle);
+            for (int reroll = 0; reroll < MAX_REROLLS && cls != WordInfo::NO_ANAGRAM_CLASS && used[cls]; ++reroll) {
+                job.request.seed = mixSeed(job.request.seed);
+                job.puzzle = generator.generate(job.request);
+                cls = classOf(job.puzzle);
+                regenerated++;
+            }
+            if (cls != WordInfo::NO_ANAGRAM_CLASS) used[cls] = true;
+        }
+    }
+
+    for (const Job& job : jobs) {
+        writeJsonLine(json, job, words);
+    }
+    json.flush();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Generated " << jobs.size() << " puzzles (" << regenerated << " regenerated to avoid repeats) in "
+        << seconds << "s on " << ThreadPool::shared().size() << " worker threads. Seed: " << baseSeed << std::endl;
+
+    std::cout.rdbuf(stdoutBuf);
+    return (json && saveCache()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,41 @@
+// Offline metrics precompute: words_processed.csv -> words_processed.metrics.csv
+//
+// Usage: WordMetrics [input.csv] [output.metrics.csv]
+//   Defaults to words_processed.csv and the .metrics.csv path next to it.
+// For every root-length word this counts its sub-words with the game's own
+// sub-word logic and difficulty rules (PuzzleRules.h), so Game::m_rebuild can
+// rank base-word candidates by lookup. Re-run after every change to the CSV or
+// to the rules, then re-run DictionaryCompiler so the image picks them up.
+
+#include "Words.h"
+#include "WordMetrics.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    const std::string csvPath = (argc > 1) ? argv[1] : "words_processed.csv";
+    const std::string metricsPath = (argc > 2) ? argv[2] : Words::metricsPathFor(csvPath);
+
+    std::vector<WordInfo> words = Words::loadProcessedWordList(csvPath);
+    if (words.empty()) {
+        std::cerr << "Nothing to do: " << csvPath << " is missing or empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Words::SubWordIndex index(words);
+    std::size_t roots = Words::computeRootMetrics(words, index);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Computed metrics for " << roots << " root words in " << seconds << "s using "
+        << ThreadPool::shared().size() << " worker threads (" << Words::simdLevelName(Words::detectSimdLevel()) << " sub-word kernel)." << std::endl;
+
+    if (!Words::writeWordMetrics(words, metricsPath)) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Wrote " << metricsPath << std::endl;
+    return EXIT_SUCCESS;
+}